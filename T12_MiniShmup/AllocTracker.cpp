@@ -0,0 +1,73 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "AllocTracker.h"
+
+using namespace std;
+
+#if T12_TRACK_ALLOCS
+
+static atomic<uint64_t> allocCount{ 0 };
+static thread_local uint64_t threadAllocCount = 0;
+
+void* CountedAlloc(size_t size)
+{
+	allocCount.fetch_add(1, memory_order_relaxed);
+	++threadAllocCount;
+	return malloc(size ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	if (void* p = CountedAlloc(size))
+		return p;
+	throw bad_alloc();
+}
+void* operator new[](size_t size)
+{
+	if (void* p = CountedAlloc(size))
+		return p;
+	throw bad_alloc();
+}
+void* operator new(size_t size, const nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
+
+uint64_t AllocCount() { return allocCount.load(memory_order_relaxed); }
+uint64_t ThreadAllocCount() { return threadAllocCount; }
+
+#else
+
+uint64_t AllocCount() { return 0; }
+uint64_t ThreadAllocCount() { return 0; }
+
+#endif
+
+void FrameAllocs::EndFrame()
+{
+	const uint32_t n = (uint32_t)(AllocCount() - frameStart);
+	if ((size_t)frames < counts.size())
+		counts[frames] = n;
+	total += n;
+	if (n)
+	{
+		++allocatingFrames;
+		lastAllocating = frames;
+	}
+	most = max(most, n);
+	++frames;
+}
+
+void FrameAllocs::Print(FILE* out) const
+{
+	fprintf(out, "allocs      %llu over %d frames, %d frames allocated, most %u in one, last on frame %d\n",
+		(unsigned long long)total, frames, allocatingFrames, most, lastAllocating);
+}
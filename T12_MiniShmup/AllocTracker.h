@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/*
+Heap allocation counter, opt in. Built with T12_TRACK_ALLOCS=1 the global
+operator new and delete are replaced with ones that count every
+allocation, in total and per thread, and every PROFILE_SCOPE records how
+many its thread made inside it (see Profiler.h) so they can be broken down
+by stage. The game and T12_Headless report how many each frame made, which
+should be none after the first (where each thread's profiler buffer is
+made): Sim::Init and the rest size their scratch for the largest pools up
+front. Built without it (the default) nothing is replaced and the counts
+stay at 0.
+*/
+
+#ifndef T12_TRACK_ALLOCS
+#define T12_TRACK_ALLOCS 0
+#endif
+
+//true if this build counts allocations
+inline bool AllocTracking() { return T12_TRACK_ALLOCS != 0; }
+//allocations made by every thread since the program started
+uint64_t AllocCount();
+//allocations made by this thread since it started
+uint64_t ThreadAllocCount();
+
+/*
+How many allocations each frame made, kept in a buffer sized up front so
+counting doesn't allocate itself
+*/
+struct FrameAllocs
+{
+	std::vector<uint32_t> counts;	//per frame, sized up front, frames past the end only go in the totals
+	int frames = 0;					//frames recorded
+	uint64_t frameStart = 0;		//AllocCount when the current frame began
+	uint64_t total = 0;				//over every frame recorded
+	int allocatingFrames = 0;		//frames that made any
+	int lastAllocating = -1;		//latest frame that made any
+	uint32_t most = 0;				//largest count in one frame
+
+	explicit FrameAllocs(int maxFrames) : counts(maxFrames) {}
+	void BeginFrame() { frameStart = AllocCount(); }
+	void EndFrame();
+	//a line of totals
+	void Print(FILE* out) const;
+};
@@ -0,0 +1,142 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "AssetBundle.h"
+
+using namespace std;
+
+bool MappedFile::Open(const string& path)
+{
+	Close();
+#if defined(_WIN32)
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (f == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER sz;
+	if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0)
+	{
+		CloseHandle(f);
+		return false;
+	}
+	HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m)
+	{
+		CloseHandle(f);
+		return false;
+	}
+	data = (const uint8_t*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(m);
+		CloseHandle(f);
+		return false;
+	}
+	file = f;
+	mapping = m;
+	size = (size_t)sz.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return false;
+	data = (const uint8_t*)p;
+	size = (size_t)st.st_size;
+#endif
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (!data)
+		return;
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+	CloseHandle((HANDLE)mapping);
+	CloseHandle((HANDLE)file);
+#else
+	munmap((void*)data, size);
+#endif
+	data = nullptr;
+	size = 0;
+	file = mapping = nullptr;
+}
+
+bool AssetBundle::Open(const string& path)
+{
+	Close();
+	if (!mapped.Open(path))
+		return false;
+
+	const BundleHeader* h = (const BundleHeader*)mapped.data;
+	bool ok = mapped.size >= sizeof(BundleHeader) &&
+		h->magic == BUNDLE_MAGIC && h->version == BUNDLE_VERSION &&
+		h->pixelOffset >= sizeof(BundleHeader) + h->numEntries * sizeof(BundleEntry) &&
+		(uint64_t)h->pixelOffset + (uint64_t)h->width * h->height * 4 <= mapped.size;
+	if (!ok)
+	{
+		mapped.Close();
+		return false;
+	}
+	header = h;
+	entries = (const BundleEntry*)(mapped.data + sizeof(BundleHeader));
+	pixels = mapped.data + h->pixelOffset;
+	return true;
+}
+
+void AssetBundle::Close()
+{
+	mapped.Close();
+	header = nullptr;
+	entries = nullptr;
+	pixels = nullptr;
+}
+
+bool WriteBundle(const string& path, uint32_t width, uint32_t height, const vector<BundleEntry>& entries, const uint8_t* pixels)
+{
+	BundleHeader h;
+	h.magic = BUNDLE_MAGIC;
+	h.version = BUNDLE_VERSION;
+	h.width = width;
+	h.height = height;
+	h.numEntries = (uint32_t)entries.size();
+	//keep the pixels 16 byte aligned in the mapping
+	const size_t headerSz = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+	h.pixelOffset = (uint32_t)((headerSz + 15) & ~(size_t)15);
+
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f)
+		return false;
+	const char pad[16] = {};
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+	if (ok && !entries.empty())
+		ok = fwrite(&entries[0], sizeof(BundleEntry), entries.size(), f) == entries.size();
+	if (ok && h.pixelOffset > headerSz)
+		ok = fwrite(pad, h.pixelOffset - headerSz, 1, f) == 1;
+	if (ok)
+		ok = fwrite(pixels, (size_t)width * height * 4, 1, f) == 1;
+	fclose(f);
+	return ok;
+}
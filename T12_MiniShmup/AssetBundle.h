@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+Prebuilt asset bundle - every image packed into one RGBA atlas by
+T12_AssetPacker, so the game maps one file and uploads one texture at
+startup instead of decoding a PNG per image.
+Layout (little endian):
+	BundleHeader
+	BundleEntry[numEntries]		- where each source image ended up
+	padding up to pixelOffset
+	width * height * 4 bytes	- raw RGBA pixels, rows top to bottom
+*/
+
+const char* const BUNDLE_FILE = "data/assets.bundle";	//where the game looks for a bundle
+const uint32_t BUNDLE_MAGIC = 0x41323154;	//"T12A"
+const uint32_t BUNDLE_VERSION = 1;
+const int BUNDLE_NAME_LEN = 56;				//longest path an entry can hold, including terminator
+
+struct BundleHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;			//atlas size in pixels
+	uint32_t height;
+	uint32_t numEntries;
+	uint32_t pixelOffset;	//from the start of the file
+};
+
+struct BundleEntry
+{
+	char name[BUNDLE_NAME_LEN];	//path of the source image, e.g. "data/ship.png"
+	int32_t x, y;				//top left in the atlas
+	int32_t w, h;				//size
+};
+
+/*
+A whole file mapped read only into memory, unmapped when closed or destroyed
+*/
+struct MappedFile
+{
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	void* file = nullptr;		//OS handles
+	void* mapping = nullptr;
+
+	MappedFile() {}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const std::string& path);
+	void Close();
+};
+
+/*
+A bundle mapped from disk, pointers are straight into the mapping
+*/
+struct AssetBundle
+{
+	MappedFile mapped;
+	const BundleHeader* header = nullptr;
+	const BundleEntry* entries = nullptr;
+	const uint8_t* pixels = nullptr;
+
+	//map and check the file, false if it's missing or not a valid bundle
+	bool Open(const std::string& path);
+	void Close();
+};
+
+/*
+Write a bundle for the packer
+pixels - width * height RGBA
+*/
+bool WriteBundle(const std::string& path, uint32_t width, uint32_t height, const std::vector<BundleEntry>& entries, const uint8_t* pixels);
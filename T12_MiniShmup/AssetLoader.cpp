@@ -0,0 +1,96 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "AssetLoader.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace sf;
+
+AssetLoader::AssetLoader(int numThreads)
+{
+	assert(numThreads > 0);
+	for (int i = 0; i < numThreads; ++i)
+		workers.emplace_back(&AssetLoader::WorkerLoop, this);
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		quit = true;
+		todo.clear();
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+}
+
+void AssetLoader::Request(const string& file)
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		todo.push_back(file);
+	}
+	wake.notify_one();
+}
+
+bool AssetLoader::Pop(Decoded& out)
+{
+	lock_guard<mutex> lock(mtx);
+	if (done.empty())
+		return false;
+	out = move(done.front());
+	done.pop_front();
+	return true;
+}
+
+void AssetLoader::WorkerLoop()
+{
+	typedef chrono::steady_clock Clock;
+	for (;;)
+	{
+		Decoded d;
+		{
+			unique_lock<mutex> lock(mtx);
+			wake.wait(lock, [this] { return quit || !todo.empty(); });
+			if (quit)
+				return;
+			d.file = todo.front();
+			todo.pop_front();
+		}
+
+		//the slow part, kept outside the lock
+		{
+			PROFILE_SCOPE("AssetLoader::Decode");
+			const Clock::time_point t0 = Clock::now();
+			d.image.reset(new Image());
+			if (!d.image->loadFromFile(d.file))
+				d.image.reset();
+			d.decodeMs = chrono::duration<double, milli>(Clock::now() - t0).count();
+		}
+
+		lock_guard<mutex> lock(mtx);
+		done.push_back(move(d));
+	}
+}
+
+bool ReadPngSize(const string& file, unsigned& width, unsigned& height)
+{
+	//8 byte signature, then IHDR must come first: length, "IHDR", big endian width and height
+	const unsigned char PNG_SIG[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	unsigned char h[24];
+	FILE* f = fopen(file.c_str(), "rb");
+	if (!f)
+		return false;
+	const size_t got = fread(h, 1, sizeof(h), f);
+	fclose(f);
+	if (got != sizeof(h) || memcmp(h, PNG_SIG, sizeof(PNG_SIG)) || memcmp(h + 12, "IHDR", 4))
+		return false;
+	width = (unsigned)h[16] << 24 | (unsigned)h[17] << 16 | (unsigned)h[18] << 8 | h[19];
+	height = (unsigned)h[20] << 24 | (unsigned)h[21] << 16 | (unsigned)h[22] << 8 | h[23];
+	return width > 0 && height > 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+/*
+Decodes image files on background threads so startup doesn't wait for
+every PNG to decompress one after another. Only the decoding happens on
+the workers, finished images come back to whoever calls Pop (the main
+thread, which owns the GL context) to be uploaded. Files are decoded
+oldest request first.
+*/
+struct AssetLoader
+{
+	//one finished file
+	struct Decoded
+	{
+		std::string file;
+		std::unique_ptr<sf::Image> image;	//null if the file was missing or not an image
+		double decodeMs = 0;				//time a worker spent on it
+	};
+
+	explicit AssetLoader(int numThreads);
+	~AssetLoader();
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	int NumThreads() const { return (int)workers.size(); }
+	//queue a file for decoding, returns straight away
+	void Request(const std::string& file);
+	//take a finished file if there is one, never waits
+	bool Pop(Decoded& out);
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> workers;
+	std::mutex mtx;
+	std::condition_variable wake;		//workers wait here for a file
+	bool quit = false;
+	std::deque<std::string> todo;		//requested, not started yet
+	std::deque<Decoded> done;			//decoded, waiting for Pop
+};
+
+/*
+Width and height of a PNG read from its header, without decoding it
+false if the file can't be read or isn't a PNG
+*/
+bool ReadPngSize(const std::string& file, unsigned& width, unsigned& height);
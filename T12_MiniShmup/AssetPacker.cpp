@@ -0,0 +1,127 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "SFML/Graphics.hpp"
+
+#include "AssetBundle.h"
+
+using namespace std;
+using namespace sf;
+
+/*
+Offline tool: pack the game's images into one atlas and write it as a
+raw asset bundle the game can map at startup.
+Usage: T12_AssetPacker [-o bundle] [image ...]
+With no images it packs everything the game loads. Run it from the
+folder containing data/ so the stored names match the game's paths.
+*/
+
+//everything Game loads, used when nothing is given on the command line
+const char* const DEFAULT_FILES[] = {
+	"data/ship.png",
+	"data/asteroid.png",
+	"data/missile-01.png",
+	"data/bgSky.png",
+	"data/bgMountainBase.png",
+	"data/bgClouds-01.png",
+	"data/bgClouds-02.png",
+	"data/bgMountains-01.png",
+	"data/bgMountains-02.png",
+	"data/bgMountains-03.png",
+	"data/bgMountains-04.png"
+};
+
+const int ATLAS_WIDTH = 2048;	//widest atlas we'll make, grows taller as needed
+const int PAD = 2;				//gap round each image, filled with its edge pixels so smoothing doesn't bleed
+
+int main(int argc, char* argv[])
+{
+	string out = BUNDLE_FILE;
+	vector<string> files;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			out = argv[++i];
+		else
+			files.push_back(argv[i]);
+	}
+	if (files.empty())
+		files.assign(DEFAULT_FILES, DEFAULT_FILES + sizeof(DEFAULT_FILES) / sizeof(DEFAULT_FILES[0]));
+
+	vector<Image> images(files.size());
+	int width = ATLAS_WIDTH;
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		if (files[i].size() >= BUNDLE_NAME_LEN)
+		{
+			printf("Name too long for the bundle: %s\n", files[i].c_str());
+			return EXIT_FAILURE;
+		}
+		if (!images[i].loadFromFile(files[i]))
+		{
+			printf("Failed to load %s\n", files[i].c_str());
+			return EXIT_FAILURE;
+		}
+		width = max(width, (int)images[i].getSize().x + 2 * PAD);
+	}
+
+	//shelf packing, tallest first so each shelf wastes as little as possible
+	vector<size_t> order(files.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	sort(order.begin(), order.end(), [&images](size_t a, size_t b) {
+		return images[a].getSize().y > images[b].getSize().y;
+	});
+	vector<BundleEntry> entries(files.size());
+	int x = 0, y = 0, shelfH = 0;
+	for (size_t n = 0; n < order.size(); ++n)
+	{
+		const size_t i = order[n];
+		const int w = (int)images[i].getSize().x + 2 * PAD;
+		const int h = (int)images[i].getSize().y + 2 * PAD;
+		if (x + w > width)
+		{
+			x = 0;
+			y += shelfH;
+			shelfH = 0;
+		}
+		BundleEntry& e = entries[i];
+		memset(e.name, 0, sizeof(e.name));
+		strncpy(e.name, files[i].c_str(), BUNDLE_NAME_LEN - 1);
+		e.x = x + PAD;
+		e.y = y + PAD;
+		e.w = (int)images[i].getSize().x;
+		e.h = (int)images[i].getSize().y;
+		x += w;
+		shelfH = max(shelfH, h);
+	}
+	const int height = y + shelfH;
+
+	//copy each image in, clamping to its edge across the padding
+	vector<Uint8> pixels((size_t)width * height * 4, 0);
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		const BundleEntry& e = entries[i];
+		const Uint8* src = images[i].getPixelsPtr();
+		for (int py = -PAD; py < e.h + PAD; ++py)
+			for (int px = -PAD; px < e.w + PAD; ++px)
+			{
+				const int sx = min(max(px, 0), e.w - 1);
+				const int sy = min(max(py, 0), e.h - 1);
+				memcpy(&pixels[((size_t)(e.y + py) * width + (e.x + px)) * 4], &src[((size_t)sy * e.w + sx) * 4], 4);
+			}
+	}
+
+	if (!WriteBundle(out, (uint32_t)width, (uint32_t)height, entries, &pixels[0]))
+	{
+		printf("Failed to write %s\n", out.c_str());
+		return EXIT_FAILURE;
+	}
+	printf("Packed %d images into a %dx%d atlas: %s\n", (int)files.size(), width, height, out.c_str());
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include "Config.h"
+
+using namespace std;
+
+/*
+Run a batch of independent seeded games with no window, for balancing.
+Usage: T12_Batch [-runs N] [-frames N] [-dt seconds] [-seed N] [-threads N]
+	[-controller scripted|random] [-sweep key from to steps] [-perrun]
+	[-config file] [-rocks N] [-max-rocks N] [-bullets N] [-max-bullets N] [-stress N] [-swept 0|1]
+	[-spawn-delay s] [-rock-clearance N] [-rock-speed N]
+Run i uses seed + i. -frames is how long each run lasts if the ship survives.
+-threads defaults to every core. -sweep repeats the batch for steps values
+of a config key (spawn_delay, rock_clearance, rock_speed, ... see Config.h)
+evenly from from to to, with the same seeds each time.
+Prints CSV, one line per batch:
+setting,value,runs,survived,survival_rate,mean_s,p10_s,p50_s,p90_s,frames,wall_ms,frames_per_sec,frames_per_sec_per_core
+-perrun adds a line per run after each: run,seed,frames,survived,ms
+*/
+
+void PrintStats(const char* setting, double value, const BatchStats& s)
+{
+	printf("%s,%g,%d,%d,%.3f,%.2f,%.2f,%.2f,%.2f,%lld,%.1f,%.0f,%.0f\n", setting, value, s.runs, s.survivors,
+		s.SurvivalRate(), s.meanSurvival, s.p10Survival, s.p50Survival, s.p90Survival, (long long)s.frames,
+		s.wallMs, s.FramesPerSec(), s.FramesPerSecPerCore());
+	fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+	BatchOptions opts;
+	int numThreads = max(1, (int)thread::hardware_concurrency());
+	const char* sweepKey = nullptr;
+	double sweepFrom = 0, sweepTo = 0;
+	int sweepSteps = 1;
+	bool perRun = false;
+	GameConfig cfg;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-runs") && i + 1 < argc)
+			opts.runs = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-frames") && i + 1 < argc)
+			opts.maxFrames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-dt") && i + 1 < argc)
+			opts.dt = (float)atof(argv[++i]);
+		else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+			opts.firstSeed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-controller") && i + 1 < argc && !strcmp(argv[i + 1], "scripted"))
+		{
+			opts.controller = ControllerT::Scripted;
+			++i;
+		}
+		else if (!strcmp(argv[i], "-controller") && i + 1 < argc && !strcmp(argv[i + 1], "random"))
+		{
+			opts.controller = ControllerT::Random;
+			++i;
+		}
+		else if (!strcmp(argv[i], "-sweep") && i + 4 < argc)
+		{
+			sweepKey = argv[++i];
+			sweepFrom = atof(argv[++i]);
+			sweepTo = atof(argv[++i]);
+			sweepSteps = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-perrun"))
+			perRun = true;
+		else if (!ParseConfigArg(argc, argv, i, cfg))
+		{
+			printf("Usage: %s [-runs N] [-frames N] [-dt seconds] [-seed N] [-threads N] [-controller scripted|random] [-sweep key from to steps] [-perrun] %s\n",
+				argv[0], CONFIG_USAGE);
+			return EXIT_FAILURE;
+		}
+	}
+	if (opts.runs <= 0 || opts.maxFrames <= 0 || opts.dt <= 0 || numThreads <= 0 || sweepSteps <= 0)
+	{
+		printf("runs, frames, dt, threads and sweep steps must be positive\n");
+		return EXIT_FAILURE;
+	}
+	if (sweepKey && !SetConfig(cfg, sweepKey, sweepFrom))
+	{
+		printf("Can't sweep %s, it isn't a config key\n", sweepKey);
+		return EXIT_FAILURE;
+	}
+
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+
+	printf("setting,value,runs,survived,survival_rate,mean_s,p10_s,p50_s,p90_s,frames,wall_ms,frames_per_sec,frames_per_sec_per_core\n");
+	vector<RunResult> results;
+	for (int step = 0; step < sweepSteps; ++step)
+	{
+		double value = 0;
+		if (sweepKey)
+		{
+			value = sweepSteps > 1 ? sweepFrom + (sweepTo - sweepFrom) * step / (sweepSteps - 1) : sweepFrom;
+			SetConfig(cfg, sweepKey, value);
+		}
+		GameConfig runCfg = cfg;
+		runCfg.Validate();
+		opts.cfg = runCfg.sim;
+		const Dim2Df screenSz{ (float)GC::SCREEN_RES.x, (float)GC::SCREEN_RES.y };
+		opts.worldSz = StressWorldSize(screenSz, opts.cfg.stressRocks);
+
+		const BatchStats stats = RunBatch(opts, pool.get(), results);
+		PrintStats(sweepKey ? sweepKey : "none", value, stats);
+		if (perRun)
+			for (size_t i = 0; i < results.size(); ++i)
+				printf("run,%u,%d,%d,%.3f\n", results[i].seed, results[i].frames, results[i].survived ? 1 : 0, results[i].ms);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+using namespace std;
+
+Input ScriptedInput(int frame)
+{
+	Input input;
+	const int SWEEP = 120;	//frames spent going each way
+	if ((frame / SWEEP) % 2)
+		input.down = true;
+	else
+		input.up = true;
+	input.fire = (frame % 10) == 0;
+	return input;
+}
+
+void Controller::Init(ControllerT type_, uint32_t seed)
+{
+	type = type_;
+	//a different stream to the Sim seeded with the same number
+	rng.Seed(seed ^ 0x85ebca6bu);
+	held = Input();
+	holdLeft = 0;
+}
+
+Input Controller::Next(int frame)
+{
+	if (type == ControllerT::Scripted)
+		return ScriptedInput(frame);
+
+	const int HOLD_MIN = 10;		//updates a direction is held for at least
+	const int HOLD_RANGE = 50;		//and up to this many more
+	const uint32_t FIRE_ODDS = 8;	//fire on one update in this many
+	if (holdLeft-- <= 0)
+	{
+		//each axis up/down/neither and left/right/neither
+		const uint32_t v = rng.Below(3), h = rng.Below(3);
+		held.up = v == 1;
+		held.down = v == 2;
+		held.left = h == 1;
+		held.right = h == 2;
+		holdLeft = HOLD_MIN + (int)rng.Below(HOLD_RANGE);
+	}
+	Input input = held;
+	input.fire = rng.Below(FIRE_ODDS) == 0;
+	return input;
+}
+
+RunResult RunOne(const BatchOptions& opts, uint32_t seed, Sim& sim)
+{
+	typedef chrono::steady_clock Clock;
+	const Clock::time_point t0 = Clock::now();
+	RunResult r;
+	r.seed = seed;
+	sim.threads = nullptr;	//runs are spread over the threads, not their insides
+	sim.bruteCollisions = false;
+	sim.Init(opts.worldSz, opts.shipSz, seed, opts.cfg);
+	Controller control;
+	control.Init(opts.controller, seed);
+	while (r.frames < opts.maxFrames && sim.ents.Active(0))
+	{
+		sim.Update(opts.dt, control.Next(r.frames));
+		++r.frames;
+	}
+	r.survived = sim.ents.Active(0);
+	r.ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+	return r;
+}
+
+BatchStats RunBatch(const BatchOptions& opts, ThreadPool* threads, vector<RunResult>& results)
+{
+	PROFILE_SCOPE("RunBatch");
+	typedef chrono::steady_clock Clock;
+	const Clock::time_point t0 = Clock::now();
+	assert(opts.runs >= 0);
+	results.assign(opts.runs, RunResult());
+
+	//one Sim per task, reused for each of its runs so their buffers are only allocated once
+	vector<unique_ptr<Sim>> sims(MaxTasks(threads));
+	ParallelFor(threads, results.size(), 1, [&](size_t begin, size_t end, int task) {
+		if (!sims[task])
+			sims[task].reset(new Sim());
+		for (size_t i = begin; i < end; ++i)
+			results[i] = RunOne(opts, opts.firstSeed + (uint32_t)i, *sims[task]);
+	});
+
+	BatchStats stats;
+	stats.runs = opts.runs;
+	stats.wallMs = chrono::duration<double, milli>(Clock::now() - t0).count();
+	stats.threads = threads ? threads->NumThreads() : 1;
+	if (results.empty())
+		return stats;
+	vector<float> lasted(results.size());
+	double totalLasted = 0;
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const RunResult& r = results[i];
+		stats.survivors += r.survived;
+		stats.frames += r.frames;
+		stats.busyMs += r.ms;
+		lasted[i] = r.frames * opts.dt;
+		totalLasted += lasted[i];
+	}
+	sort(lasted.begin(), lasted.end());
+	stats.meanSurvival = (float)(totalLasted / results.size());
+	stats.p10Survival = lasted[lasted.size() / 10];
+	stats.p50Survival = lasted[lasted.size() / 2];
+	stats.p90Survival = lasted[lasted.size() * 9 / 10];
+	return stats;
+}
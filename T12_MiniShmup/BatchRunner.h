@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Sim.h"
+
+struct ThreadPool;
+
+/*
+Many independent seeded games run side by side with no window, for
+balancing sweeps. Each run owns its Sim, Rng and Controller and nothing is
+shared between them, so every run plays out the same on its own as it does
+in a batch, whatever the thread count.
+*/
+
+enum class ControllerT
+{
+	Scripted,	//ScriptedInput, the same moves every run
+	Random		//random moves from the run's own Rng
+};
+
+/*
+A repeatable stand in for the player - sweeps up and down and
+fires every few frames
+*/
+Input ScriptedInput(int frame);
+
+/*
+Flies the ship when there's no player. Random holds a random direction for
+a random number of updates and fires now and then.
+*/
+struct Controller
+{
+	ControllerT type = ControllerT::Scripted;
+	Rng rng;			//random moves, its own stream so the simulation's isn't disturbed
+	Input held;			//direction being held
+	int holdLeft = 0;	//updates before picking another
+
+	void Init(ControllerT type_, uint32_t seed);
+	//input for this update
+	Input Next(int frame);
+};
+
+struct BatchOptions
+{
+	int runs = 1000;
+	int maxFrames = 60 * 60;				//updates per run, stops early if the ship is destroyed
+	float dt = 1.f / GC::TICK_RATE;			//every update's elapsed time
+	uint32_t firstSeed = 1;					//run i uses firstSeed + i
+	ControllerT controller = ControllerT::Scripted;
+	Dim2Df worldSz{ (float)GC::SCREEN_RES.x, (float)GC::SCREEN_RES.y };
+	Dim2Df shipSz = GC::HEADLESS_SHIP_SIZE;
+	SimConfig cfg;							//pools and balancing, the same for every run
+};
+
+//how one run went
+struct RunResult
+{
+	uint32_t seed = 0;
+	int frames = 0;			//updates it ran
+	bool survived = false;	//ship still alive at the end
+	double ms = 0;			//wall time it took
+};
+
+//a whole batch summed up
+struct BatchStats
+{
+	int runs = 0;
+	int survivors = 0;			//ran all maxFrames without the ship being destroyed
+	float meanSurvival = 0;		//seconds of game time the ship lasted, averaged
+	float p10Survival = 0;		//10% of runs lasted this long or less
+	float p50Survival = 0;
+	float p90Survival = 0;
+	int64_t frames = 0;			//updates across every run
+	double wallMs = 0;			//start to finish
+	double busyMs = 0;			//every run's time added up, the core time it used
+	int threads = 1;
+
+	float SurvivalRate() const { return runs ? (float)survivors / runs : 0.f; }
+	//simulated frames a second for the whole batch, and for each core working on it
+	double FramesPerSec() const { return wallMs > 0 ? frames * 1000.0 / wallMs : 0.0; }
+	double FramesPerSecPerCore() const { return busyMs > 0 ? frames * 1000.0 / busyMs : 0.0; }
+};
+
+/*
+Play out a single run with seed
+sim - scratch, set up from scratch by Init so it can be reused from run to run
+*/
+RunResult RunOne(const BatchOptions& opts, uint32_t seed, Sim& sim);
+
+/*
+Play out every run of opts, spread over threads (null runs them one after another)
+results - one per run in seed order
+*/
+BatchStats RunBatch(const BatchOptions& opts, ThreadPool* threads, std::vector<RunResult>& results);
@@ -0,0 +1,283 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Sim.h"
+#include "Sorting.h"
+#include "ThreadPool.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+/*
+Microbenchmarks for the collision, spawn, snapshot and sort paths, no window needed.
+Every case builds a seeded random world so runs are repeatable, and the
+world grows with the entity count so the density stays the same.
+Usage: T12_Bench [-filter name] [-min N] [-max N] [-mintime seconds] [-seed N] [-threads N]
+Prints CSV: benchmark,entities,iterations,ns_per_op,items_per_sec
+*/
+
+const size_t BENCH_SIZES[] = { 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000 };
+//world area per entity, about 10x the area of an average rock
+const float AREA_PER_ENTITY = 6000.f;
+//PlaceRocks gets a sparser world so it has room for all GC::NUM_ROCKS
+const float PLACE_AREA_SCALE = 16.f;
+//one in this many active entities is a bullet, about the game's mix of rocks and bullets
+const size_t BULLET_EVERY = 10;
+//the O(n^2) cases would take minutes beyond these
+const size_t BRUTE_MAX = 50000;
+const size_t BUBBLE_MAX = 10000;
+
+struct BenchOptions
+{
+	const char* filter = nullptr;	//only run benchmarks whose name contains this
+	size_t minCount = 0;
+	size_t maxCount = 1000000;
+	double minTime = 0.25;			//seconds to keep repeating each case for
+	uint32_t seed = 1;
+	ThreadPool* threads = nullptr;
+};
+
+/*
+Call fn until at least minTime has passed and print how long each call took
+items - how much work one call does, e.g. entities tested, for items/sec
+*/
+template<class Fn>
+void Measure(const BenchOptions& opts, const char* name, size_t count, double items, Fn&& fn)
+{
+	typedef chrono::steady_clock Clock;
+	fn();	//warm up caches and buffers
+	long long iters = 0;
+	long long batch = 1;
+	double elapsed = 0;
+	while (elapsed < opts.minTime)
+	{
+		const Clock::time_point t0 = Clock::now();
+		for (long long i = 0; i < batch; ++i)
+			fn();
+		elapsed += chrono::duration<double>(Clock::now() - t0).count();
+		iters += batch;
+		batch *= 2;
+	}
+	const double nsPerOp = elapsed * 1e9 / iters;
+	printf("%s,%zu,%lld,%.1f,%.0f\n", name, count, iters, nsPerOp, items * iters / elapsed);
+	fflush(stdout);
+}
+
+/*
+Same as Measure but calls reset before every call, outside the timing, for
+work that changes what it runs on. Each call is timed on its own so it's
+only for cases much slower than reading the clock.
+*/
+template<class Fn, class Reset>
+void MeasureEach(const BenchOptions& opts, const char* name, size_t count, double items, Fn&& fn, Reset&& reset)
+{
+	typedef chrono::steady_clock Clock;
+	reset();
+	fn();	//warm up caches and buffers
+	long long iters = 0;
+	double elapsed = 0;
+	while (elapsed < opts.minTime)
+	{
+		reset();
+		const Clock::time_point t0 = Clock::now();
+		fn();
+		elapsed += chrono::duration<double>(Clock::now() - t0).count();
+		++iters;
+	}
+	const double nsPerOp = elapsed * 1e9 / iters;
+	printf("%s,%zu,%lld,%.1f,%.0f\n", name, count, iters, nsPerOp, items * iters / elapsed);
+	fflush(stdout);
+}
+
+//square world big enough for count entities at the usual density times areaScale
+Dim2Df BenchWorld(size_t count, float areaScale = 1.f)
+{
+	const float side = sqrtf(count * AREA_PER_ENTITY * areaScale);
+	return Dim2Df{ side, side };
+}
+
+/*
+count active entities scattered at random, overlaps allowed, plus spare
+inactive rocks left in the pool for spawning. A ship first and one in
+BULLET_EVERY a bullet, the rest rocks, so every contact type turns up.
+*/
+void MakeWorld(Entities& ents, const Dim2Df& worldSz, size_t count, size_t spare, Rng& rng)
+{
+	ents.Clear();
+	ents.Resize(count + spare);
+	for (size_t i = 0; i < count + spare; ++i)
+	{
+		if (i == 0 && count)
+			InitShip(ents, i, worldSz, GC::HEADLESS_SHIP_SIZE);
+		else if (i < count && i % BULLET_EVERY == 0)
+			InitBullet(ents, i);
+		else
+			InitRock(ents, i, rng);
+		ents.x[i] = rng.GetRandRange(0.f, worldSz.x);
+		ents.y[i] = rng.GetRandRange(0.f, worldSz.y);
+		//as if they'd just made one normal update's move, for the swept tests
+		ents.prevX[i] = ents.x[i] - ents.vx[i] / GC::TICK_RATE;
+		ents.prevY[i] = ents.y[i];
+		ents.SetActive(i, i < count);
+	}
+	ents.RebuildPools();
+}
+
+//stand in for Background, only z matters to the sort
+struct BenchLayer
+{
+	float z;
+	float speed;
+	void* tex;
+};
+
+bool Wanted(const BenchOptions& opts, const char* name, size_t count)
+{
+	return count >= opts.minCount && count <= opts.maxCount && (!opts.filter || strstr(name, opts.filter));
+}
+
+void RunBenchmarks(const BenchOptions& opts)
+{
+	printf("benchmark,entities,iterations,ns_per_op,items_per_sec\n");
+	for (size_t s = 0; s < sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]); ++s)
+	{
+		const size_t n = BENCH_SIZES[s];
+		const Dim2Df worldSz = BenchWorld(n);
+		Rng rng;
+		rng.Seed(opts.seed);
+		Entities ents;
+		MakeWorld(ents, worldSz, n, 1, rng);
+		TaskBuffers tasks;
+		tasks.Resize(MaxTasks(opts.threads));
+
+		//hits damage and deactivate things, so each check starts from the same world
+		const Entities start = ents;
+		auto restore = [&] { ents = start; };
+		if (n <= BRUTE_MAX && Wanted(opts, "CheckCollisions", n))
+			MeasureEach(opts, "CheckCollisions", n, (double)n, [&] { CheckCollisions(ents, opts.threads, tasks); }, restore);
+
+		SpatialGrid grid;
+		if (Wanted(opts, "CheckCollisionsGrid", n))
+			MeasureEach(opts, "CheckCollisionsGrid", n, (double)n, [&] { CheckCollisionsGrid(ents, grid, opts.threads, tasks); }, restore);
+		if (Wanted(opts, "CheckCollisionsGridSwept", n))
+			MeasureEach(opts, "CheckCollisionsGridSwept", n, (double)n, [&] { CheckCollisionsGrid(ents, grid, opts.threads, tasks, true); }, restore);
+		restore();
+
+		//one circle against every entity, different place each time
+		if (Wanted(opts, "IsColliding", n))
+		{
+			volatile bool sink = false;
+			Measure(opts, "IsColliding", n, (double)n, [&] {
+				sink = IsColliding(ents, rng.GetRandRange(0.f, worldSz.x), rng.GetRandRange(0.f, worldSz.y), 20.f);
+			});
+		}
+
+		//take the spare rock, try it off the right edge, give it back
+		if (Wanted(opts, "SpawnRock", n))
+		{
+			Measure(opts, "SpawnRock", n, (double)n, [&] {
+				if (SpawnRock(worldSz, ents, rng, 0.f))
+					ents.Release(ents.Size() - 1);
+			});
+		}
+
+		//the same but finding room from the broadphase grid, as the game does
+		if (Wanted(opts, "SpawnRockGrid", n))
+		{
+			grid.Clear();
+			for (size_t i = 0; i < ents.Size(); ++i)
+				if (ents.Active(i))
+					grid.Add(ents.x[i], ents.y[i], ents.radius[i], (int)i);
+			grid.Build();
+			SpawnQuery query;
+			Measure(opts, "SpawnRockGrid", n, (double)n, [&] {
+				query.Reset(&grid);
+				if (SpawnRock(worldSz, ents, rng, 0.f, &query))
+					ents.Release(ents.Size() - 1);
+			});
+		}
+
+		//copy the whole simulation state out and back, items/sec is entities copied
+		if (Wanted(opts, "SnapshotSave", n) || Wanted(opts, "SnapshotRestore", n))
+		{
+			Sim sim;
+			sim.worldSz = worldSz;
+			sim.ents = ents;
+			SimSnapshot snap;
+			snap.Save(sim);
+			if (Wanted(opts, "SnapshotSave", n))
+				Measure(opts, "SnapshotSave", n, (double)n, [&] { snap.Save(sim); });
+			if (Wanted(opts, "SnapshotRestore", n))
+				Measure(opts, "SnapshotRestore", n, (double)n, [&] { snap.Restore(sim); });
+		}
+
+		//a full PlaceRocks into a world that already has n entities, then cut it back
+		if (Wanted(opts, "PlaceRocks", n))
+		{
+			const Dim2Df placeSz = BenchWorld(n, PLACE_AREA_SCALE);
+			MakeWorld(ents, placeSz, n, 0, rng);
+			Measure(opts, "PlaceRocks", n, (double)GC::NUM_ROCKS, [&] {
+				PlaceRocks(placeSz, ents, rng);
+				ents.Resize(n);
+			});
+		}
+
+		//shuffled layers re-sorted each time, the copy is small next to the sort
+		vector<BenchLayer> layers(n), sorted;
+		for (size_t i = 0; i < n; ++i)
+			layers[i] = BenchLayer{ rng.GetRandRange(0.f, GC::BG_Z_MAX), 0.f, nullptr };
+		if (n <= BUBBLE_MAX && Wanted(opts, "Bubble", n))
+		{
+			Measure(opts, "Bubble", n, (double)n, [&] {
+				sorted = layers;
+				Bubble(sorted);
+			});
+		}
+		if (Wanted(opts, "SortByZ", n))
+		{
+			Measure(opts, "SortByZ", n, (double)n, [&] {
+				sorted = layers;
+				SortByZ(sorted);
+			});
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions opts;
+	int numThreads = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-filter") && i + 1 < argc)
+			opts.filter = argv[++i];
+		else if (!strcmp(argv[i], "-min") && i + 1 < argc)
+			opts.minCount = (size_t)atol(argv[++i]);
+		else if (!strcmp(argv[i], "-max") && i + 1 < argc)
+			opts.maxCount = (size_t)atol(argv[++i]);
+		else if (!strcmp(argv[i], "-mintime") && i + 1 < argc)
+			opts.minTime = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+			opts.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			numThreads = atoi(argv[++i]);
+		else
+		{
+			printf("Usage: %s [-filter name] [-min N] [-max N] [-mintime seconds] [-seed N] [-threads N]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+	opts.threads = pool.get();
+	RunBenchmarks(opts);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+#include <assert.h>
+
+#include "CircleKernel.h"
+
+#if !defined(CIRCLE_KERNEL_SCALAR)
+#if defined(__AVX2__)
+#define CIRCLE_KERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CIRCLE_KERNEL_SSE
+#include <emmintrin.h>
+#endif
+#endif
+
+/*
+Scalar version, finishes off whatever the wide loops leave
+*/
+static uint32_t OverlapScalar(float x, float y, float r, const float* xs, const float* ys, const float* rs, int first, int count)
+{
+	uint32_t mask = 0;
+	for (int i = first; i < count; ++i)
+	{
+		const float dx = xs[i] - x;
+		const float dy = ys[i] - y;
+		const float minDist = r + rs[i];
+		if (dx * dx + dy * dy <= minDist * minDist)
+			mask |= 1u << i;
+	}
+	return mask;
+}
+
+uint32_t CircleOverlapMask(float x, float y, float r, const float* xs, const float* ys, const float* rs, int count)
+{
+	assert(count >= 0 && count <= CIRCLE_BLOCK_MAX);
+	uint32_t mask = 0;
+	int i = 0;
+#if defined(CIRCLE_KERNEL_AVX2)
+	const __m256 cx = _mm256_set1_ps(x);
+	const __m256 cy = _mm256_set1_ps(y);
+	const __m256 cr = _mm256_set1_ps(r);
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), cx);
+		const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), cy);
+		const __m256 minDist = _mm256_add_ps(_mm256_loadu_ps(rs + i), cr);
+		const __m256 dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		const __m256 hit = _mm256_cmp_ps(dist2, _mm256_mul_ps(minDist, minDist), _CMP_LE_OQ);
+		mask |= (uint32_t)_mm256_movemask_ps(hit) << i;
+	}
+#elif defined(CIRCLE_KERNEL_SSE)
+	const __m128 cx = _mm_set1_ps(x);
+	const __m128 cy = _mm_set1_ps(y);
+	const __m128 cr = _mm_set1_ps(r);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), cx);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), cy);
+		const __m128 minDist = _mm_add_ps(_mm_loadu_ps(rs + i), cr);
+		const __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		const __m128 hit = _mm_cmple_ps(dist2, _mm_mul_ps(minDist, minDist));
+		mask |= (uint32_t)_mm_movemask_ps(hit) << i;
+	}
+#endif
+	return mask | OverlapScalar(x, y, r, xs, ys, rs, i, count);
+}
+
+const char* CircleKernelName()
+{
+#if defined(CIRCLE_KERNEL_AVX2)
+	return "avx2";
+#elif defined(CIRCLE_KERNEL_SSE)
+	return "sse";
+#else
+	return "scalar";
+#endif
+}
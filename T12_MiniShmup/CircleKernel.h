@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+Batched circle overlap test, the inner loop of collision and placement.
+Uses squared distances so there's no sqrt, and AVX2 (8 wide) or SSE (4 wide)
+when the compiler is targeting them, with a plain loop for the leftovers.
+Define CIRCLE_KERNEL_SCALAR to force the plain loop, e.g. to compare results.
+*/
+
+//most circles one call can test, one bit each in the returned mask
+const int CIRCLE_BLOCK_MAX = 32;
+
+/*
+Test one circle against a packed block of others
+x,y,r - the circle
+xs,ys,rs - count other circles, count <= CIRCLE_BLOCK_MAX
+returns a mask with bit i set if circle i is touching (distance <= r + rs[i])
+*/
+uint32_t CircleOverlapMask(float x, float y, float r, const float* xs, const float* ys, const float* rs, int count);
+
+//index of the lowest set bit in a hit mask, mask must not be zero
+inline int LowestSetBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (int)idx;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+//which version of the kernel got compiled in
+const char* CircleKernelName();
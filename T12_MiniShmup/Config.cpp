@@ -0,0 +1,167 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "Config.h"
+
+using namespace std;
+
+/*
+Each setting once, with its key in a file and its flag on the command line,
+exactly one of the three fields saying where it goes, and the largest value
+it takes (0 for no limit)
+*/
+struct ConfigKey
+{
+	const char* key;
+	const char* flag;
+	int GameConfig::* field;
+	int SimConfig::* simField;
+	float SimConfig::* simFloat;
+	double most;
+};
+
+const ConfigKey CONFIG_KEYS[] = {
+	{ "rocks", "-rocks", nullptr, &SimConfig::rocks, nullptr, GC::ROCKS_MAX },
+	{ "max_rocks", "-max-rocks", nullptr, &SimConfig::maxRocks, nullptr, GC::ROCKS_MAX },
+	{ "bullets", "-bullets", nullptr, &SimConfig::bullets, nullptr, GC::BULLETS_MAX },
+	{ "max_bullets", "-max-bullets", nullptr, &SimConfig::maxBullets, nullptr, GC::BULLETS_MAX },
+	{ "stress_rocks", "-stress", nullptr, &SimConfig::stressRocks, nullptr, GC::STRESS_ROCKS_MAX },
+	{ "swept", "-swept", nullptr, &SimConfig::swept, nullptr, 0 },
+	{ "spawn_delay", "-spawn-delay", nullptr, nullptr, &SimConfig::spawnDelay, 0 },
+	{ "rock_clearance", "-rock-clearance", nullptr, nullptr, &SimConfig::rockClearance, 0 },
+	{ "rock_speed", "-rock-speed", nullptr, nullptr, &SimConfig::rockSpeed, 0 },
+	{ "bg_min", "-bg-min", &GameConfig::bgMin, nullptr, nullptr, 0 },
+	{ "bg_max", "-bg-max", &GameConfig::bgMax, nullptr, nullptr, 0 },
+};
+const int NUM_CONFIG_KEYS = sizeof(CONFIG_KEYS) / sizeof(CONFIG_KEYS[0]);
+
+void SetConfigValue(GameConfig& cfg, const ConfigKey& k, double value)
+{
+	if (k.field)
+		cfg.*k.field = (int)value;
+	else if (k.simField)
+		cfg.sim.*k.simField = (int)value;
+	else
+		cfg.sim.*k.simFloat = (float)value;
+}
+
+//null if there's no such key
+const ConfigKey* FindConfigKey(const char* key)
+{
+	for (int k = 0; k < NUM_CONFIG_KEYS; ++k)
+		if (!strcmp(CONFIG_KEYS[k].key, key))
+			return &CONFIG_KEYS[k];
+	return nullptr;
+}
+
+//false if value is over the key's limit
+bool InRange(const ConfigKey& k, double value)
+{
+	return k.most == 0 || value <= k.most;
+}
+
+bool SetConfig(GameConfig& cfg, const char* key, double value)
+{
+	const ConfigKey* k = FindConfigKey(key);
+	if (!k)
+		return false;
+	SetConfigValue(cfg, *k, value);
+	return true;
+}
+
+void GameConfig::Validate()
+{
+	sim.Validate();
+	bgMin = max(bgMin, 0);
+	bgMax = max(bgMax, bgMin);
+}
+
+//strip spaces and tabs from both ends
+char* Trim(char* s)
+{
+	while (*s == ' ' || *s == '\t')
+		++s;
+	char* end = s + strlen(s);
+	while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n'))
+		--end;
+	*end = 0;
+	return s;
+}
+
+bool LoadConfig(const string& path, GameConfig& cfg)
+{
+	FILE* f = fopen(path.c_str(), "r");
+	if (!f)
+		return false;
+	bool ok = true;
+	char line[256];
+	for (int lineNum = 1; fgets(line, sizeof(line), f); ++lineNum)
+	{
+		if (char* hash = strchr(line, '#'))
+			*hash = 0;
+		char* key = Trim(line);
+		if (!*key)
+			continue;
+		char* eq = strchr(key, '=');
+		char* end = nullptr;
+		double value = 0;
+		if (eq)
+		{
+			*eq = 0;
+			key = Trim(key);
+			value = strtod(eq + 1, &end);
+		}
+		if (!eq || end == eq + 1 || *Trim(end))
+		{
+			printf("%s(%d): expected key = number\n", path.c_str(), lineNum);
+			ok = false;
+			continue;
+		}
+		const ConfigKey* k = FindConfigKey(key);
+		if (!k)
+			printf("%s(%d): unknown setting %s\n", path.c_str(), lineNum, key);
+		else if (!InRange(*k, value))
+		{
+			printf("%s(%d): %s can be at most %.0f\n", path.c_str(), lineNum, key, k->most);
+			ok = false;
+		}
+		else
+			SetConfigValue(cfg, *k, value);
+	}
+	fclose(f);
+	return ok;
+}
+
+bool ParseConfigArg(int argc, char* argv[], int& i, GameConfig& cfg)
+{
+	if (i + 1 >= argc)
+		return false;
+	if (!strcmp(argv[i], "-config"))
+	{
+		if (!LoadConfig(argv[i + 1], cfg))
+		{
+			printf("Couldn't read config %s\n", argv[i + 1]);
+			return false;
+		}
+		++i;
+		return true;
+	}
+	for (int k = 0; k < NUM_CONFIG_KEYS; ++k)
+		if (!strcmp(argv[i], CONFIG_KEYS[k].flag))
+		{
+			const double value = atof(argv[i + 1]);
+			if (!InRange(CONFIG_KEYS[k], value))
+			{
+				printf("%s can be at most %.0f\n", argv[i], CONFIG_KEYS[k].most);
+				return false;
+			}
+			SetConfigValue(cfg, CONFIG_KEYS[k], value);
+			++i;
+			return true;
+		}
+	return false;
+}
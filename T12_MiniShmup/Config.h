@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+
+#include "GameConstants.h"
+#include "Sim.h"
+
+/*
+Capacities and balancing that used to be fixed in GC, read at startup from a config file
+and/or the command line (later ones win). The file is plain text, one
+"key = value" per line, # starts a comment:
+	rocks = 2000
+	max_rocks = 100000
+	bullets = 50
+	max_bullets = 200
+	stress_rocks = 1000000
+	swept = 1
+	spawn_delay = 0.01
+	rock_clearance = 2
+	rock_speed = 150
+	bg_min = 12
+	bg_max = 24
+The matching flags are -rocks, -max-rocks, -bullets, -max-bullets, -stress,
+-swept, -spawn-delay, -rock-clearance, -rock-speed, -bg-min and -bg-max, and
+-config file reads a file at that point. Pool sizes over GC::ROCKS_MAX,
+GC::BULLETS_MAX and GC::STRESS_ROCKS_MAX are rejected.
+*/
+struct GameConfig
+{
+	SimConfig sim;					//entity pools and stress mode
+	int bgMin = GC::BG_NUM_MIN;		//fewest random background layers
+	int bgMax = GC::BG_NUM_MAX;		//most random background layers
+
+	//keep everything in range, call after loading
+	void Validate();
+};
+
+/*
+Read settings from a file over the top of cfg, unknown keys are reported and skipped
+returns false if the file can't be opened, a line can't be read or a value is too big
+*/
+bool LoadConfig(const std::string& path, GameConfig& cfg);
+
+/*
+Set one setting by its key in a file, e.g. for sweeping it over a range
+returns false if there's no such key, a value that's too big is left for Validate to clamp
+*/
+bool SetConfig(GameConfig& cfg, const char* key, double value);
+
+/*
+Try argv[i] as one of the config flags, on success i is left on the last
+argument used. Returns false if it isn't one, or its value is missing or
+too big or the -config file couldn't be read, so the caller can print its usage.
+*/
+bool ParseConfigArg(int argc, char* argv[], int& i, GameConfig& cfg);
+
+//usage text for the config flags, to go on the end of each program's own
+const char* const CONFIG_USAGE = "[-config file] [-rocks N] [-max-rocks N] [-bullets N] [-max-bullets N] [-stress N] [-swept 0|1] [-spawn-delay s] [-rock-clearance N] [-rock-speed N] [-bg-min N] [-bg-max N]";
@@ -0,0 +1,106 @@
+#include <assert.h>
+#include <algorithm>
+
+#include "Contacts.h"
+#include "Sim.h"
+#include "SpatialGrid.h"
+
+using namespace std;
+
+/*
+What one type does to another when they touch, a is always type A and b type B.
+Only pairs listed in CONTACT_TYPES get one.
+*/
+template<ObjectT A, ObjectT B>
+struct ContactRule;
+
+template<>
+struct ContactRule<ObjectT::Ship, ObjectT::Rock>
+{
+	static void Respond(Entities& ents, size_t ship, size_t rock)
+	{
+		TakeDamage(ents, ship, 1);
+		TakeDamage(ents, rock, 999);
+	}
+};
+
+template<>
+struct ContactRule<ObjectT::Bullet, ObjectT::Rock>
+{
+	static void Respond(Entities& ents, size_t bullet, size_t rock)
+	{
+		TakeDamage(ents, bullet, 1);
+		TakeDamage(ents, rock, 1);
+	}
+};
+
+//mark both as colliding and apply the rule, whichever way round the pair was packed
+template<ObjectT A, ObjectT B>
+void Collide(Entities& ents, size_t lo, size_t hi)
+{
+	assert(GetContactType(ents.type[lo], ents.type[hi]) != NO_CONTACT);
+	ents.SetColliding(lo, true);
+	ents.SetColliding(hi, true);
+	if (ents.type[lo] == A)
+		ContactRule<A, B>::Respond(ents, lo, hi);
+	else
+		ContactRule<A, B>::Respond(ents, hi, lo);
+}
+
+template<ObjectT A, ObjectT B>
+void RespondBatch(Entities& ents, const vector<uint64_t>& pairs)
+{
+	int a = -1;
+	bool aActive = false;
+	for (size_t p = 0; p < pairs.size(); ++p)
+	{
+		//nothing between the start of a row and its first hit can change a's
+		//flag, so sampling it here is the same as sampling at the row start
+		if (SpatialGrid::PairLow(pairs[p]) != a)
+		{
+			a = SpatialGrid::PairLow(pairs[p]);
+			aActive = ents.Active(a);
+		}
+		const int b = SpatialGrid::PairHigh(pairs[p]);
+		if (aActive && ents.Active(b))
+			Collide<A, B>(ents, a, b);
+	}
+}
+
+template<ObjectT A, ObjectT B>
+void RespondTimedBatch(Entities& ents, vector<TimedHit>& hits)
+{
+	sort(hits.begin(), hits.end());
+	for (size_t p = 0; p < hits.size(); ++p)
+	{
+		const int a = SpatialGrid::PairLow(hits[p].pair), b = SpatialGrid::PairHigh(hits[p].pair);
+		if (ents.Active(a) && ents.Active(b))
+			Collide<A, B>(ents, a, b);
+	}
+}
+
+/*
+The batch passes for each contact type, in ContactT order
+*/
+struct ContactHandlers
+{
+	void (*respond)(Entities& ents, const vector<uint64_t>& pairs);
+	void (*respondTimed)(Entities& ents, vector<TimedHit>& hits);
+};
+
+const ContactHandlers CONTACT_HANDLERS[NUM_CONTACT_TYPES] = {
+	{ &RespondBatch<ObjectT::Ship, ObjectT::Rock>, &RespondTimedBatch<ObjectT::Ship, ObjectT::Rock> },
+	{ &RespondBatch<ObjectT::Bullet, ObjectT::Rock>, &RespondTimedBatch<ObjectT::Bullet, ObjectT::Rock> },
+};
+
+void RespondToContacts(Entities& ents, int type, const vector<uint64_t>& pairs)
+{
+	assert(type >= 0 && type < NUM_CONTACT_TYPES);
+	CONTACT_HANDLERS[type].respond(ents, pairs);
+}
+
+void RespondToTimedContacts(Entities& ents, int type, vector<TimedHit>& hits)
+{
+	assert(type >= 0 && type < NUM_CONTACT_TYPES);
+	CONTACT_HANDLERS[type].respondTimed(ents, hits);
+}
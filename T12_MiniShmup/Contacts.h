@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include "Entities.h"
+
+/*
+What happens when two types of entity touch.
+Collision detection sorts touching pairs into one buffer per contact type
+and each buffer is then resolved in its own pass, through a rule picked at
+compile time for that pair of types (see ContactRule in Contacts.cpp), so
+there's no switch on ObjectT per pair. Type pairs with no rule, like rock
+on rock, are dropped before the narrow phase.
+*/
+
+//pairs of types that do something, resolved in this order
+enum ContactT : int { CONTACT_SHIP_ROCK, CONTACT_BULLET_ROCK, NUM_CONTACT_TYPES };
+const int NO_CONTACT = -1;
+
+//contact type of each pair of ObjectTs, either way round
+const int8_t CONTACT_TYPES[NUM_OBJECT_TYPES][NUM_OBJECT_TYPES] = {
+	//Ship				Rock					Bullet
+	{ NO_CONTACT,		CONTACT_SHIP_ROCK,		NO_CONTACT },			//Ship
+	{ CONTACT_SHIP_ROCK,	NO_CONTACT,			CONTACT_BULLET_ROCK },	//Rock
+	{ NO_CONTACT,		CONTACT_BULLET_ROCK,	NO_CONTACT },			//Bullet
+};
+
+//which buffer a touching pair goes in, NO_CONTACT if it can be ignored
+inline int GetContactType(ObjectT a, ObjectT b) { return CONTACT_TYPES[(int)a][(int)b]; }
+
+/*
+A touching pair and how far through the update they first touched
+*/
+struct TimedHit
+{
+	float toi;		//0 to 1, time of impact as a fraction of the update
+	uint64_t pair;	//packed low<<32|high
+
+	bool operator<(const TimedHit& o) const { return toi < o.toi || (toi == o.toi && pair < o.pair); }
+};
+
+/*
+Respond to one contact type's pairs in order, as if each row of pairs were
+visited one after the other: the first entity's active flag is sampled when
+its row starts and the second's just before responding, as hits deactivate
+things along the way. Both get the colliding flag.
+type - contact type every pair belongs to
+pairs - packed low<<32|high, sorted ascending
+*/
+void RespondToContacts(Entities& ents, int type, const std::vector<uint64_t>& pairs);
+
+/*
+Respond to one contact type's swept hits in the order they happened, a pair
+is skipped if either side was deactivated by an earlier hit
+hits - gets sorted by time of impact
+*/
+void RespondToTimedContacts(Entities& ents, int type, std::vector<TimedHit>& hits);
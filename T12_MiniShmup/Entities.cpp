@@ -0,0 +1,112 @@
+#include <assert.h>
+
+#include "Entities.h"
+
+void Entities::Clear()
+{
+	x.clear();
+	y.clear();
+	prevX.clear();
+	prevY.clear();
+	vx.clear();
+	vy.clear();
+	radius.clear();
+	w.clear();
+	h.clear();
+	type.clear();
+	flags.clear();
+	health.clear();
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+	{
+		pools[t].free.clear();
+		pools[t].total = 0;
+	}
+}
+
+size_t Entities::Add(ObjectT type_)
+{
+	x.push_back(0);
+	y.push_back(0);
+	prevX.push_back(0);
+	prevY.push_back(0);
+	vx.push_back(0);
+	vy.push_back(0);
+	radius.push_back(0);
+	w.push_back(0);
+	h.push_back(0);
+	type.push_back(type_);
+	flags.push_back(0);
+	health.push_back(1);
+	return x.size() - 1;
+}
+
+void Entities::Resize(size_t n)
+{
+	x.resize(n, 0);
+	y.resize(n, 0);
+	prevX.resize(n, 0);
+	prevY.resize(n, 0);
+	vx.resize(n, 0);
+	vy.resize(n, 0);
+	radius.resize(n, 0);
+	w.resize(n, 0);
+	h.resize(n, 0);
+	type.resize(n, ObjectT::Rock);
+	flags.resize(n, 0);
+	health.resize(n, 1);
+}
+
+void Entities::Reserve(size_t n)
+{
+	x.reserve(n);
+	y.reserve(n);
+	prevX.reserve(n);
+	prevY.reserve(n);
+	vx.reserve(n);
+	vy.reserve(n);
+	radius.reserve(n);
+	w.reserve(n);
+	h.reserve(n);
+	type.reserve(n);
+	flags.reserve(n);
+	health.reserve(n);
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+		pools[t].free.reserve(n);
+}
+
+void Entities::RebuildPools()
+{
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+	{
+		pools[t].free.clear();
+		pools[t].free.reserve(Size());
+		pools[t].total = 0;
+	}
+	//backwards so the lowest index gets handed out first
+	for (size_t i = Size(); i > 0; --i)
+	{
+		++pools[(int)type[i - 1]].total;
+		if (!Active(i - 1))
+			pools[(int)type[i - 1]].Release(i - 1);
+	}
+}
+
+size_t Entities::Acquire(ObjectT type_)
+{
+	size_t idx = pools[(int)type_].Acquire();
+	if (idx != SIZE_MAX)
+	{
+		assert(!Active(idx) && type[idx] == type_);
+		SetActive(idx, true);
+	}
+	return idx;
+}
+
+void Entities::Release(size_t i)
+{
+	if (Active(i))
+	{
+		SetActive(i, false);
+		pools[(int)type[i]].Release(i);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+//what is this?
+enum class ObjectT : uint8_t { Ship, Rock, Bullet };
+const int NUM_OBJECT_TYPES = 3;
+
+/*
+Inactive entities of one type waiting to be reused.
+A stack of indices so handing one out and taking it back are both O(1).
+*/
+struct EntityPool
+{
+	std::vector<size_t> free;	//inactive indices, the last one is handed out next
+	size_t total = 0;			//entities of this type, free or not, counted by RebuildPools
+
+	//an inactive index or SIZE_MAX if they are all in use
+	size_t Acquire()
+	{
+		if (free.empty())
+			return SIZE_MAX;
+		size_t idx = free.back();
+		free.pop_back();
+		return idx;
+	}
+	void Release(size_t idx) { free.push_back(idx); }
+};
+
+/*
+Simulation state for every game object, stored as parallel arrays
+(structure of arrays) so the update and collision loops walk tightly
+packed data. Anything only needed for drawing lives elsewhere, at the
+same index (see Object).
+*/
+struct Entities
+{
+	//bits in flags
+	enum : uint8_t {
+		ACTIVE = 1,			//should we be updating and rendering this one?
+		COLLIDING = 2		//did we hit something on the last update
+	};
+
+	std::vector<float> x;			//centre position
+	std::vector<float> y;
+	std::vector<float> prevX;		//position at the start of the last update, for interpolating when drawing
+	std::vector<float> prevY;
+	std::vector<float> vx;			//velocity in units per second
+	std::vector<float> vy;
+	std::vector<float> radius;		//collision radius
+	std::vector<float> w;			//size on screen, used to keep things on screen or tell when they've left it
+	std::vector<float> h;
+	std::vector<ObjectT> type;
+	std::vector<uint8_t> flags;
+	std::vector<int> health;		//go inactive if health <= 0
+	EntityPool pools[NUM_OBJECT_TYPES];	//inactive entities by type
+
+	size_t Size() const { return x.size(); }
+	//remove everything
+	void Clear();
+	//add an inactive entity with everything zeroed, returns its index
+	size_t Add(ObjectT type_);
+	//grow with inactive rocks or chop off the end
+	void Resize(size_t n);
+	//make room for n entities so growing to that many, and their pools, doesn't allocate
+	void Reserve(size_t n);
+	//refill the pools from the active flags, call after setting up or adding entities
+	void RebuildPools();
+	//activate an inactive entity of this type, returns SIZE_MAX if there are none left
+	size_t Acquire(ObjectT type_);
+	//deactivate an entity and put it back in its pool, does nothing if already inactive
+	void Release(size_t i);
+
+	bool Active(size_t i) const { return (flags[i] & ACTIVE) != 0; }
+	bool Colliding(size_t i) const { return (flags[i] & COLLIDING) != 0; }
+	//just sets the flag, the pools are not updated - use Acquire and Release once running
+	void SetActive(size_t i, bool on) { flags[i] = (uint8_t)(on ? (flags[i] | ACTIVE) : (flags[i] & ~ACTIVE)); }
+	//make it look like it's always been here, e.g. after a spawn, so drawing doesn't slide it in
+	void SnapPrev(size_t i) { prevX[i] = x[i]; prevY[i] = y[i]; }
+	void SetColliding(size_t i, bool on) { flags[i] = (uint8_t)(on ? (flags[i] | COLLIDING) : (flags[i] & ~COLLIDING)); }
+};
@@ -0,0 +1,122 @@
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "FramePacer.h"
+#include "Profiler.h"
+
+using namespace std;
+
+int64_t RealClock::Now()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RealClock::Sleep(int64_t ns)
+{
+	this_thread::sleep_for(chrono::nanoseconds(ns));
+}
+
+int FrameBucket(int64_t ns)
+{
+	return (int)min<int64_t>(max<int64_t>(ns, 0) / FrameStats::BUCKET_NS, FrameStats::NUM_BUCKETS - 1);
+}
+
+void FrameStats::Add(int64_t ns, bool miss)
+{
+	if (times.size() < (size_t)WINDOW)
+	{
+		times.push_back(ns);
+		missed.push_back(miss);
+	}
+	else
+	{
+		//the oldest drops out of the window
+		--buckets[FrameBucket(times[next])];
+		windowMisses -= missed[next];
+		times[next] = ns;
+		missed[next] = miss;
+	}
+	next = (next + 1) % WINDOW;
+	++buckets[FrameBucket(ns)];
+	windowMisses += miss;
+	++frames;
+	misses += miss;
+	worst = max(worst, ns);
+}
+
+int64_t FrameStats::Percentile(float p) const
+{
+	const int want = max(1, (int)ceilf(p * WindowSize()));
+	int seen = 0;
+	for (int b = 0; b < NUM_BUCKETS; ++b)
+	{
+		seen += buckets[b];
+		if (seen >= want)
+			return (b + 1) * BUCKET_NS;
+	}
+	return NUM_BUCKETS * BUCKET_NS;
+}
+
+void FrameStats::Print(FILE* out) const
+{
+	fprintf(out, "Frames: %lld, %lld missed (%.2f%%), worst %.2f ms\n", (long long)frames, (long long)misses,
+		frames ? 100.0 * misses / frames : 0.0, worst / 1e6);
+	if (times.empty())
+		return;
+	fprintf(out, "Last %d: %d missed, p50 <= %.1f ms, p99 <= %.1f ms\n", WindowSize(), windowMisses,
+		Percentile(0.5f) / 1e6, Percentile(0.99f) / 1e6);
+	const int BAR_MAX = 50;
+	int most = 0;
+	for (int b = 0; b < NUM_BUCKETS; ++b)
+		most = max(most, buckets[b]);
+	for (int b = 0; b < NUM_BUCKETS; ++b)
+		if (buckets[b])
+			fprintf(out, "%5.1f ms%s %5d %s\n", (b + 1) * BUCKET_NS / 1e6, b == NUM_BUCKETS - 1 ? "+" : " ", buckets[b],
+				string(max(1, buckets[b] * BAR_MAX / most), '#').c_str());
+}
+
+void FramePacer::Start(PaceClock& clock_, float fps)
+{
+	clock = &clock_;
+	period = fps > 0 ? (int64_t)(1e9 / fps) : 0;
+	lastFrame = clock->Now();
+	deadline = lastFrame + period;
+	stats = FrameStats();
+	//so adding frames never allocates
+	stats.times.reserve(FrameStats::WINDOW);
+	stats.missed.reserve(FrameStats::WINDOW);
+}
+
+float FramePacer::Wait()
+{
+	PROFILE_SCOPE("FramePacer::Wait");
+	assert(clock);
+	int64_t now = clock->Now();
+	if (period > 0 && now < deadline)
+	{
+		if (deadline - now > spinMargin)
+		{
+			const int64_t want = deadline - spinMargin;
+			clock->Sleep(want - now);
+			now = clock->Now();
+			//the wake ate most of the margin, stop sleeping earlier from now on
+			const int64_t late = now - want;
+			if (late > spinMargin * 3 / 4)
+				spinMargin = min(period, late * 2);
+		}
+		while (now < deadline)
+			now = clock->Now();
+	}
+
+	const bool miss = period > 0 && now - deadline > missTolerance;
+	stats.Add(now - lastFrame, miss);
+	const float elapsed = (now - lastFrame) / 1e9f;
+	lastFrame = now;
+	//after a miss start again from here, don't try to fit the lost time into the next frames
+	deadline = miss ? now + period : deadline + period;
+	return elapsed;
+}
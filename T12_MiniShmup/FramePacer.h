@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/*
+Where FramePacer gets the time from and how it waits, all in nanoseconds.
+RealClock is the steady clock and the OS's sleep, SimClock only moves when
+told to so pacing can be run headless with no real waiting and the same
+numbers every time.
+*/
+struct PaceClock
+{
+	virtual ~PaceClock() {}
+	//time since some fixed point
+	virtual int64_t Now() = 0;
+	//give the CPU away for about ns, the OS may wake us late
+	virtual void Sleep(int64_t ns) = 0;
+};
+
+struct RealClock : PaceClock
+{
+	int64_t Now() override;
+	void Sleep(int64_t ns) override;
+};
+
+/*
+Simulated time. A sleep takes what was asked plus sleepSlop, standing in
+for an OS that wakes late, and every Now costs pollCost so spinning on it
+still gets somewhere.
+*/
+struct SimClock : PaceClock
+{
+	int64_t now = 0;
+	int64_t sleepSlop = 0;		//added to every sleep
+	int64_t pollCost = 1000;	//added by every Now
+
+	int64_t Now() override { now += pollCost; return now; }
+	void Sleep(int64_t ns) override { now += ns + sleepSlop; }
+	//stand in for a frame's work
+	void Advance(int64_t ns) { now += ns; }
+};
+
+/*
+The last WINDOW frame times and which of them missed their deadline,
+bucketed as they're added so percentiles and the histogram cost the same
+however long it's been running. Totals cover every frame since the start.
+*/
+struct FrameStats
+{
+	static const int WINDOW = 600;			//frames kept, 10 seconds at 60
+	static const int64_t BUCKET_NS = 500000;	//histogram resolution, 0.5ms
+	static const int NUM_BUCKETS = 100;		//the last bucket takes everything longer, 50ms+
+
+	std::vector<int64_t> times;		//ring of frame times
+	std::vector<uint8_t> missed;	//ring, 1 where that frame missed
+	size_t next = 0;				//where the next frame goes in the rings
+	int buckets[NUM_BUCKETS] = {};	//frames in the window by time
+	int windowMisses = 0;			//misses in the window
+	int64_t frames = 0;				//every frame since the start
+	int64_t misses = 0;				//every miss since the start
+	int64_t worst = 0;				//longest frame since the start
+
+	void Add(int64_t ns, bool miss);
+	//frames in the window, less than WINDOW until it fills
+	int WindowSize() const { return (int)times.size(); }
+	//frame time that fraction p (0 to 1) of the window is at or under, to the top of its bucket
+	int64_t Percentile(float p) const;
+	//totals, percentiles and a histogram of the window
+	void Print(FILE* out) const;
+};
+
+/*
+Keeps frames to a steady rate without setFramerateLimit's coarse,
+OS dependent sleep. Wait sleeps until spinMargin before the next frame is
+due, then spins on the clock for the rest. Any sleep that wakes later than
+that grows spinMargin to cover it. A frame that starts more than
+missTolerance after its deadline, from too much work or a late wake, is a
+miss, and the schedule restarts from there rather than rushing the next
+frames to catch up.
+*/
+struct FramePacer
+{
+	PaceClock* clock = nullptr;		//not owned
+	int64_t period = 0;				//time per frame, 0 doesn't wait, only measures
+	int64_t spinMargin = 1000000;	//stop sleeping this long before the deadline and spin
+	int64_t missTolerance = 500000;	//how late a frame can start and still be on time
+	int64_t deadline = 0;			//when the next frame is due to start
+	int64_t lastFrame = 0;			//when the last one started
+	FrameStats stats;
+
+	//fps - frames per second to hold, 0 runs flat out
+	void Start(PaceClock& clock_, float fps);
+	/*
+	call at the end of each frame, returns once the next is due
+	returns seconds since the last call, for moving the game on by
+	*/
+	float Wait();
+};
@@ -3,69 +3,18 @@
 #include <math.h>
 #include <sstream>
 #include <algorithm>
+#include <thread>
 
 #include "Game.h"
+#include "AssetBundle.h"
+#include "Profiler.h"
+#include "Sorting.h"
+#include "SfmlRenderer.h"
 
 using namespace std;
 using namespace sf;
 
-/*
-Seed random number generator
-s=a fixed value to use (for debugging perhaps) or
-let it default to -1 and time is used instead
-*/
-void Seed(int s = -1)
-{
-	if (s == -1)
-		srand((unsigned int)time(0));
-	else
-		srand(s);
-}
-
-/*
-float value between min and max inclusive
-*/
-float GetRandRange(float min, float max)
-{
-	float alpha = rand() / (float)RAND_MAX;
-	alpha = min + (max - min) * alpha;
-	return alpha;
-}
-
-/*
-integer variant
-*/
-int GetRandRange(int min, int max)
-{
-	float alpha = GetRandRange(0.f, 1.f);
-	return min + (int)round((max - min) * alpha);
-}
-
-/*
-Bubble sorter
-sprites - a vector of GameObjects to sort by z
-*/
-void Bubble(vector<Background>& sprites)
-{
-	bool busy = true;
-	while (busy)
-	{
-		busy = false;
-		for (size_t i = 0; i < (sprites.size() - 1); ++i)
-		{
-			if (sprites[i].z > sprites[i + 1].z)
-			{
-				Background o = sprites[i];
-				sprites[i] = sprites[i + 1];
-				sprites[i + 1] = o;
-				busy = true;
-			}
-		}
-	}
-}
-
-
-void Background::Update(RenderWindow& window, float elapsed)
+void Background::Update(float elapsed)
 {
 	Vector2f pos = spr.getPosition();
 	pos.x -= elapsed * speed;
@@ -75,209 +24,6 @@ void Background::Update(RenderWindow& window, float elapsed)
 	spr.setPosition(pos);
 }
 
-void Object::InitShip(RenderWindow& window, Texture& tex)
-{
-	spr.setTexture(tex, true);
-	const IntRect& texRect = spr.getTextureRect();
-	spr.setOrigin(texRect.width / 2.f, texRect.height / 2.f);
-	spr.setScale(0.2f, 0.2f);
-	spr.setRotation(90);
-	spr.setPosition(spr.getGlobalBounds().width * 0.6f, window.getSize().y / 2.f);
-	type = ObjectT::Ship;
-	radius = 25.f;
-	active = true;
-}
-
-void Object::InitRock(RenderWindow& window, Texture& tex)
-{
-	spr.setTexture(tex);
-	IntRect texR(0, 0, 96, 96);
-	spr.setTextureRect(texR);
-	spr.setOrigin(texR.width / 2.f, texR.height / 2.f);
-	radius = 10.f + (float)(rand() % 30);
-	float scale = 0.75f * (radius / 25.f);
-	spr.setScale(scale, scale);
-	health = (int)(5 * scale);
-	active = false;
-	type = ObjectT::Rock;
-}
-
-void Object::InitBullet(RenderWindow& window, Texture& tex)
-{
-	spr.setTexture(tex);
-	IntRect texR(0, 0, 32, 32);
-	spr.setTextureRect(texR);
-	spr.setOrigin(texR.width / 2.f, texR.height / 2.f);
-	radius = 5.f;
-	float scale = 0.5f;
-	spr.setScale(scale, scale);
-	active = false;
-	type = ObjectT::Bullet;
-}
-
-void Object::Init(RenderWindow& window, Texture& tex, ObjectT type_)
-{
-	switch (type_)
-	{
-	case ObjectT::Ship:
-		InitShip(window, tex);
-		break;
-	case ObjectT::Rock:
-		InitRock(window, tex);
-		break;
-	case ObjectT::Bullet:
-		InitBullet(window, tex);
-		break;
-	default:
-		assert(false);
-	}
-}
-
-void Object::Update(RenderWindow& window, float elapsed, vector<Object>& objects, bool fire)
-{
-	if (active)
-	{
-		colliding = false;
-		switch (type)
-		{
-		case ObjectT::Ship:
-			PlayerControl(window.getSize(), elapsed, objects, fire);
-			break;
-		case ObjectT::Rock:
-			MoveRock(elapsed);
-			break;
-		case ObjectT::Bullet:
-			MoveBullet(window.getSize(), elapsed);
-			break;
-		}
-	}
-}
-
-void Object::MoveRock(float elapsed)
-{
-	const Vector2f& pos = spr.getPosition();
-	float x = pos.x - GC::ROCK_SPEED * elapsed;
-	if (x < -spr.getGlobalBounds().width / 2.f)
-		active = false;
-	spr.setPosition(x, pos.y);
-}
-
-void Object::MoveBullet(const sf::Vector2u& screenSz, float elapsed)
-{
-	const Vector2f& pos = spr.getPosition();
-	float x = pos.x + 250 * elapsed;
-	if (x > (screenSz.x + spr.getGlobalBounds().width / 2.f))
-		active = false;
-	spr.setPosition(x, pos.y);
-}
-
-void Object::Render(RenderWindow& window)
-{
-	if (active)
-		window.draw(spr);
-}
-
-Vector2f Decay(Vector2f& currentVal, float rate, float perSec, float dTimeS)
-{
-	float mod = 1.0f - rate * (dTimeS / perSec);
-	Vector2f alpha(currentVal.x * mod, currentVal.y * mod);
-	return alpha;
-}
-
-void Object::PlayerControl(const Vector2u& screenSz, float elapsed, std::vector<Object>& objects, bool fire)
-{
-	Vector2f pos = spr.getPosition();
-	const float SPEED = 250.f;
-	FloatRect rect = spr.getGlobalBounds();
-
-	static Vector2f thrust{ 0,0 };
-
-	if (Keyboard::isKeyPressed(Keyboard::Up) ||
-		Keyboard::isKeyPressed(Keyboard::Down) ||
-		Keyboard::isKeyPressed(Keyboard::Left) ||
-		Keyboard::isKeyPressed(Keyboard::Right))
-	{
-		if (Keyboard::isKeyPressed(Keyboard::Up))
-			thrust.y = -SPEED;
-		else if (Keyboard::isKeyPressed(Keyboard::Down))
-			thrust.y = SPEED;
-		if (Keyboard::isKeyPressed(Keyboard::Left))
-			thrust.x = -SPEED;
-		else if (Keyboard::isKeyPressed(Keyboard::Right))
-			thrust.x = SPEED;
-	}
-
-	pos += thrust * elapsed;
-	thrust = Decay(thrust, 0.1f, 0.02f, elapsed);
-
-	if (pos.y < (rect.height * 0.6f))
-		pos.y = rect.height * 0.6f;
-	if (pos.y > (screenSz.y - rect.height * 0.6f))
-		pos.y = screenSz.y - rect.height * 0.6f;
-	if (pos.x < (rect.width * 0.6f))
-		pos.x = rect.width * 0.6f;
-	if (pos.x > (screenSz.x - rect.width * 0.6f))
-		pos.x = screenSz.x - rect.width * 0.6f;
-
-	spr.setPosition(pos);
-
-	if (fire)
-	{
-		pos.x = pos.x + spr.getGlobalBounds().width / 2.f;
-		FireBullet(pos, objects);
-	}
-}
-
-void Object::FireBullet(const Vector2f& pos, std::vector<Object>& objects)
-{
-	size_t idx = 0;
-	bool found = false;
-	while (idx < objects.size() && !found)
-	{
-		if (!objects[idx].active && objects[idx].type == ObjectT::Bullet)
-			found = true;
-		else
-			++idx;
-	}
-	if (idx < objects.size())
-	{
-		objects[idx].active = true;
-		objects[idx].spr.setPosition(pos);
-	}
-}
-
-void Object::Hit(Object& other)
-{
-	switch (type)
-	{
-	case ObjectT::Ship:
-		if (other.type == ObjectT::Rock)
-		{
-			TakeDamage(1);
-			other.TakeDamage(999);	
-		}
-		break;
-	case ObjectT::Bullet:
-		if (other.type == ObjectT::Rock)
-		{
-			TakeDamage(1);
-			other.TakeDamage(1);
-		}
-		break;
-	case ObjectT::Rock:
-		break;
-	default:
-		assert(false);
-	}
-}
-
-void Object::TakeDamage(int amount)
-{
-	health -= amount;
-	if (health <= 0)
-		active = false;
-}
-
 bool LoadTexture(const string& file, Texture& tex)
 {
 	if (tex.loadFromFile(file))
@@ -289,161 +35,48 @@ bool LoadTexture(const string& file, Texture& tex)
 	return false;
 }
 
-void DrawCircle(RenderWindow& window, const Vector2f& pos, float radius, Color col)
-{
-	CircleShape c;
-	c.setRadius(radius);
-	c.setPointCount(20);
-	c.setOutlineColor(col);
-	c.setOutlineThickness(2);
-	c.setFillColor(Color::Transparent);
-	c.setPosition(pos);
-	c.setOrigin(radius, radius);
-	window.draw(c);
-}
-
-bool CircleToCircle(const Vector2f& pos1, const Vector2f& pos2, float minDist)
-{
-	float dist = (pos1.x - pos2.x) * (pos1.x - pos2.x) +
-		(pos1.y - pos2.y) * (pos1.y - pos2.y);
-	dist = sqrtf(dist);
-	return dist <= minDist;
-}
-
-void CheckCollisions(vector<Object>& objects, RenderWindow& window, bool debug)
-{
-	if (objects.size() > 1)
-	{
-		for (size_t i = 0; i < objects.size(); ++i)
-		{
-			Object& a = objects[i];
-			if (a.active)
-			{
-				if (i < (objects.size() - 1))
-					for (size_t ii = i + 1; ii < (objects.size()); ++ii)
-					{
-						Object& b = objects[ii];
-						if (b.active)
-						{
-							if (CircleToCircle(a.spr.getPosition(), b.spr.getPosition(), a.radius + b.radius))
-							{
-								a.colliding = true;
-								b.colliding = true;
-								a.Hit(b);
-								b.Hit(a);
-							}
-						}
-					}
-				if (debug)
-				{
-					Color col = Color::Green;
-					if (a.colliding)
-						col = Color::Red;
-					DrawCircle(window, a.spr.getPosition(), a.radius, col);
-				}
-			}
-		}
-	}
-}
-
-
-bool IsColliding(Object& obj, vector<Object>& objects)
-{
-	assert(obj.active);
-	size_t idx = 0;
-	bool colliding = false;
-	while (idx < objects.size() && !colliding) {
-
-		if (&obj != &objects[idx] && objects[idx].active)
-		{
-			const Vector2f& posA = obj.spr.getPosition();
-			const Vector2f& posB = objects[idx].spr.getPosition();
-			float dist = obj.radius + objects[idx].radius;
-			colliding = CircleToCircle(posA, posB, dist);
-		}
-		++idx;
-	}
-	return colliding;
-}
+//loading progress along the bottom of the screen
+const float LOADING_BAR_HEIGHT = 4.f;
 
+/*
+Every image a background layer can use
+*/
+const char* const BG_FILES[] = {
+	"data/bgSky.png",
+	"data/bgMountainBase.png",
+	"data/bgClouds-01.png",
+	"data/bgClouds-02.png",
+	"data/bgMountains-01.png",
+	"data/bgMountains-02.png",
+	"data/bgMountains-03.png",
+	"data/bgMountains-04.png"
+};
 
-void PlaceRocks(RenderWindow& window, Texture& tex, vector<Object>& objects)
-{
-	bool space = true;
-	int ctr = GC::NUM_ROCKS;
-	while (space && ctr)
-	{
-		Object rock;
-		rock.Init(window, tex, Object::ObjectT::Rock);
-		rock.radius *= GC::ROCK_MIN_DIST;
-		int tries = 0;
-		do {
-			tries++;
-			float x = (float)(rand() % window.getSize().x);
-			float y = (float)(rand() % window.getSize().y);
-			rock.spr.setPosition(x, y);
-		} while (tries < GC::PLACE_TRIES && IsColliding(rock, objects));
-		rock.radius *= 1 / GC::ROCK_MIN_DIST;
-		if (tries != GC::PLACE_TRIES)
-			objects.push_back(rock);
-		else
-			space = false;
-		--ctr;
-	}
-}
-
-bool SpawnRock(RenderWindow& window, vector<Object>& objects, float extraClearance)
+void Game::GenerateBgTextures()
 {
-	size_t idx = 0;
-	bool found = false;
-	while (idx < objects.size() && !found)
-	{
-		Object& obj = objects[idx];
-		if (!obj.active && obj.type == Object::ObjectT::Rock)
-			found = true;
-		else
-			++idx;
-	}
-
-	if (found)
-	{
-		Object& obj = objects[idx];
-		obj.active = true;
-		obj.radius += extraClearance;
-		FloatRect r = obj.spr.getGlobalBounds();
-		float y = (r.height / 2.f) + (rand() % (int)(window.getSize().y - r.height));
-		obj.spr.setPosition(window.getSize().x + r.width, y);
-		if (IsColliding(obj, objects))
-		{
-			found = false;
-			obj.active = false;
-		}
-		obj.radius -= extraClearance;
-	}
-	return found;
+	for (size_t i = 0; i < sizeof(BG_FILES) / sizeof(BG_FILES[0]); ++i)
+		textures.GetRegion(BG_FILES[i]);
 }
 
-void Game::GenerateBgTextures()
+void Game::SetBgImage(Background& bg, const std::string& file)
 {
-	LoadTexture("data/bgClouds-01.png", texBgCloud1);
-	LoadTexture("data/bgClouds-02.png", texBgCloud2);
+	TextureRegion region = textures.GetRegion(file);
+	bg.tex = region.tex;
+	SetRegion(bg.spr, region);
 }
 
 void Game::GenerateBgRandom()
 {
-	int bgNum = GetRandRange(GC::BG_NUM_MIN, GC::BG_NUM_MAX);
-	backgrounds.resize(bgNum + 2, Background());
+	int bgNum = rng.GetRandRange(cfg.bgMin, cfg.bgMax);
+	backgrounds.clear();
+	backgrounds.resize(bgNum + 2);
 
-	backgrounds[0].tex.create(GC::BG_PNG_SIZE.x, GC::BG_PNG_SIZE.y);
-	LoadTexture("data/bgSky.png", backgrounds[0].tex);
-	backgrounds[0].spr.setTexture(backgrounds[0].tex);
+	SetBgImage(backgrounds[0], "data/bgSky.png");
 	backgrounds[0].spr.setScale(GC::BG_SCALE_RATIO.x, GC::BG_SCALE_RATIO.y);
 	backgrounds[0].speed = 0;
 	backgrounds[0].spr.setPosition(0, 0);
 
-	backgrounds[1].tex.create(GC::BG_PNG_SIZE.x, GC::BG_PNG_SIZE.y);
-	LoadTexture("data/bgMountainBase.png", backgrounds[1].tex);
-	backgrounds[1].spr.setTexture(backgrounds[1].tex);
+	SetBgImage(backgrounds[1], "data/bgMountainBase.png");
 	backgrounds[1].spr.setScale(GC::BG_SCALE_RATIO.x, GC::BG_SCALE_RATIO.y);
 	backgrounds[1].speed = 0;
 	backgrounds[1].spr.setPosition(0, 0);
@@ -451,112 +84,209 @@ void Game::GenerateBgRandom()
 	for (size_t i = 2; i < backgrounds.size(); ++i)
 	{
 		Background& o = backgrounds[i];
-		o.tex.create(GC::BG_PNG_SIZE.x, GC::BG_PNG_SIZE.y);
-		o.z = GetRandRange(0.f, GC::BG_Z_MAX);
+		o.z = rng.GetRandRange(0.f, GC::BG_Z_MAX);
 
 		if (o.z > (GC::BG_Z_MAX * GC::BG_Z_FAR))
 		{
-			if (GetRandRange(0, 1))
-				LoadTexture("data/bgClouds-02.png", o.tex);
+			if (rng.GetRandRange(0, 1))
+				SetBgImage(o, "data/bgClouds-02.png");
 			else
-				LoadTexture("data/bgMountains-04.png", o.tex);
+				SetBgImage(o, "data/bgMountains-04.png");
 		}
 		else
 		{
-			int choice = GetRandRange(1, 4);
+			int choice = rng.GetRandRange(1, 4);
 			switch (choice)
 			{
 				case 1:
-					LoadTexture("data/bgClouds-01.png", o.tex);
+					SetBgImage(o, "data/bgClouds-01.png");
 					break;
 
 				case 2:
-					LoadTexture("data/bgMountains-01.png", o.tex);
+					SetBgImage(o, "data/bgMountains-01.png");
 					break;
 
 				case 3:
-					LoadTexture("data/bgMountains-02.png", o.tex);
+					SetBgImage(o, "data/bgMountains-02.png");
 					break;
 
 				case 4:
-					LoadTexture("data/bgMountains-03.png", o.tex);
+					SetBgImage(o, "data/bgMountains-03.png");
 					break;
 
 				default:
 					assert(false);
 			}
 		}
-		o.spr.setTexture(o.tex);
 	}
 
-	Bubble(backgrounds);
+	SortByZ(backgrounds);
 
 	for (size_t i = 2; i < backgrounds.size(); ++i)
 	{
 		float scale = GC::BG_SCALE_MAX - (GC::BG_SCALE_RANGE * backgrounds[i].z / GC::BG_Z_MAX);
 		backgrounds[i].spr.setScale(GC::BG_SCALE_RATIO.x, scale);
 		backgrounds[i].speed = GC::BG_SPEED_MIN + ((GC::BG_SPEED_MAX - GC::BG_SPEED_MIN) * backgrounds[i].z / GC::BG_Z_MAX);
-		backgrounds[i].spr.setPosition((GetRandRange(0.f, (float)backgrounds[i].spr.getGlobalBounds().width) - (float)backgrounds[i].spr.getGlobalBounds().width),
+		backgrounds[i].spr.setPosition((rng.GetRandRange(0.f, (float)backgrounds[i].spr.getGlobalBounds().width) - (float)backgrounds[i].spr.getGlobalBounds().width),
 			GC::SCREEN_RES.y - (float)backgrounds[i].spr.getGlobalBounds().height - backgrounds[i].z);
 	}
 }
 
-void Game::Init(sf::RenderWindow& window)
+const TextureRegion& Game::TextureFor(ObjectT type) const
 {
-	LoadTexture("data/ship.png", texShip);
-	LoadTexture("data/asteroid.png", texRock);
-	LoadTexture("data/missile-01.png", texBullet);
+	switch (type)
+	{
+	case ObjectT::Ship:
+		return texShip;
+	case ObjectT::Rock:
+		return texRock;
+	case ObjectT::Bullet:
+		return texBullet;
+	default:
+		assert(false);
+		return texRock;
+	}
+}
 
-	objects.clear();
-	Object rock;
-	rock.Init(window, texRock, Object::ObjectT::Rock);
-	objects.insert(objects.begin(), GC::NUM_ROCKS + 1, rock);
-	objects[0].Init(window, texShip, Object::ObjectT::Ship);
-	for (size_t i = 1; i < objects.size(); ++i)
-		objects[i].Init(window, texRock, Object::ObjectT::Rock);
+void Game::Init(sf::RenderWindow& window, uint32_t seed, const GameConfig& cfg_)
+{
+	cfg = cfg_;
+	cfg.Validate();
+	//backgrounds get their own stream so they don't disturb the simulation's
+	rng.Seed(seed ^ 0x9e3779b9u);
 
-	Object bullet;
-	bullet.Init(window, texBullet, Object::ObjectT::Bullet);
-	objects.insert(objects.end(), 50, bullet);
+	//one mapped atlas if it's been built, otherwise each PNG gets decoded in the background
+	if (!textures.LoadBundle(BUNDLE_FILE))
+	{
+		const int numThreads = max(1, (int)thread::hardware_concurrency() - 1);
+		loader.reset(new AssetLoader(numThreads));
+		textures.loader = loader.get();
+	}
+	texShip = textures.GetRegion("data/ship.png");
+	texRock = textures.GetRegion("data/asteroid.png");
+	texBullet = textures.GetRegion("data/missile-01.png");
+
+	//the ship is drawn on its side so width and height swap over
+	Dim2Df shipSz{ texShip.rect.height * GC::SHIP_SCALE, texShip.rect.width * GC::SHIP_SCALE };
+	Dim2Df worldSz{ (float)window.getSize().x, (float)window.getSize().y };
+	worldSz = StressWorldSize(worldSz, cfg.sim.stressRocks);
+	sim.Init(worldSz, shipSz, seed, cfg.sim);
+	recording.Start(seed, worldSz, shipSz, sim.cfg);
+	//a snapshot of a stress world is far too big to keep a few seconds of
+	history.Resize(cfg.sim.stressRocks ? 0 : GC::REWIND_HISTORY, sim.ents.Size());
 
-	spawnTimer = 0;
-	spawnDelay = 0.01f;
-	rockShipClearance = objects[0].spr.getGlobalBounds().width * 2.f;
+	objects.clear();
+	AddObjects();
 
 	GenerateBgTextures();
 	GenerateBgRandom();
 }
 
-void Game::Update(sf::RenderWindow& window, float elapsed, bool fire)
+void Game::AddObjects()
 {
-	spawnTimer += elapsed;
-	if (spawnTimer >= spawnDelay)
+	objects.reserve(sim.MaxEntities());
+	for (size_t i = objects.size(); i < sim.ents.Size(); ++i)
 	{
-		if (SpawnRock(window, objects, rockShipClearance))
-			spawnTimer = 0;
+		const TextureRegion& region = TextureFor(sim.ents.type[i]);
+		objects.emplace_back(region.tex.get(), ToRenderRect(region.rect), sim.ents, i);
 	}
+}
 
-	CheckCollisions(objects, window, false);
-	for (size_t i = 0; i < objects.size(); ++i)
-		objects[i].Update(window, elapsed, objects, fire);
+bool Game::UpdateAssets()
+{
+	if (!loader)
+		return true;
+	PROFILE_SCOPE("Game::UpdateAssets");
+	textures.Upload(GC::ASSET_UPLOADS_PER_FRAME);
+	if (textures.Loading())
+		return false;
+	//anything asked for later loads on the spot, it's all in the cache already
+	textures.loader = nullptr;
+	loader.reset();
+	return true;
+}
 
-	for (size_t i = 2; i < backgrounds.size(); ++i)
-		backgrounds[i].Update(window, elapsed);
+void Game::SetThreads(int numThreads)
+{
+	sim.threads = nullptr;
+	threads.reset(numThreads > 1 ? new ThreadPool(numThreads) : nullptr);
+	sim.threads = threads.get();
+	//size the new task count's buffers now rather than on the next update
+	sim.tasks.Reserve(MaxTasks(sim.threads), sim.MaxEntities());
+}
+
+void Game::Update(float elapsed, const Input& input)
+{
+	if (recordInput)
+		recording.Add(elapsed, input);
+	history.Push(sim);
+	sim.Update(elapsed, input);
+	AddObjects();
+}
+
+bool Game::Rewind(int updates)
+{
+	if (history.count == 0 || updates <= 0)
+		return false;
+	const SimSnapshot* snap = history.Get(min((size_t)updates, history.count) - 1);
+	history.Rollback(sim, snap->Frame());
+	//entities are only ever added on the end, so any sprites past the end go and the rest still match
+	objects.resize(sim.ents.Size());
+	recording.Truncate(sim.frame);
+	return true;
 }
 
-void Game::Render(sf::RenderWindow& window)
+bool Game::SaveRecording(const std::string& file)
 {
-	window.draw(backgrounds[0].spr);
-	window.draw(backgrounds[1].spr);
+	recording.endHash = HashState(sim.ents);
+	return recording.Save(file);
+}
+
+void Game::UpdateBackgrounds(float elapsed)
+{
+	PROFILE_SCOPE("Game::UpdateBackgrounds");
+	//layers only move themselves, with a normal handful this stays on the main thread
+	const size_t BG_TASK_MIN = 64;
+	ParallelFor(threads.get(), backgrounds.size() - 2, BG_TASK_MIN, [&](size_t begin, size_t end, int) {
+		for (size_t i = begin + 2; i < end + 2; ++i)
+			backgrounds[i].Update(elapsed);
+	});
+}
+
+void Game::Render(RenderBackend& r, float alpha)
+{
+	PROFILE_SCOPE("Game::Render");
+	r.Begin();
+	r.DrawSprite(ToRenderSprite(backgrounds[0].spr));
+	r.DrawSprite(ToRenderSprite(backgrounds[1].spr));
 	for (size_t i = backgrounds.size() - 1; i > 2; --i)
 	{
-		window.draw(backgrounds[i].spr);
-		FloatRect rect = backgrounds[i].spr.getGlobalBounds();
-		backgrounds[i].spr.setPosition(rect.left + rect.width, rect.top);
-		window.draw(backgrounds[i].spr);
-		backgrounds[i].spr.setPosition(rect.left, rect.top);
+		//twice, side by side, so it wraps as it scrolls
+		RenderSprite spr = ToRenderSprite(backgrounds[i].spr);
+		r.DrawSprite(spr);
+		spr.x += backgrounds[i].spr.getGlobalBounds().width;
+		r.DrawSprite(spr);
 	}
 
+	//a stress mode world can be bigger than the screen, shrink it to fit
+	if (cfg.sim.stressRocks)
+		r.SetView(sim.worldSz.x, sim.worldSz.y);
 	for (size_t i = 0; i < objects.size(); ++i)
-		objects[i].Render(window);
-}
\ No newline at end of file
+		objects[i].Render(r, sim.ents, i, alpha);
+
+	if (debugCollisions)
+	{
+		PROFILE_SCOPE("DrawCollisions");
+		DrawCollisions(r, sim.ents);
+	}
+	//a bar along the bottom while images are still coming in
+	if (textures.Loading())
+	{
+		r.SetView((float)GC::SCREEN_RES.x, (float)GC::SCREEN_RES.y);
+		const float w = GC::SCREEN_RES.x * textures.Progress();
+		const float y0 = GC::SCREEN_RES.y - LOADING_BAR_HEIGHT, y1 = (float)GC::SCREEN_RES.y;
+		const RenderVertex bar[4] = { { 0, y0, 0, 0 }, { 0, y1, 0, 0 }, { w, y1, 0, 0 }, { w, y0, 0, 0 } };
+		r.DrawQuad(nullptr, bar, RENDER_WHITE);
+	}
+	drawCalls = r.End();
+}
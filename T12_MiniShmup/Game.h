@@ -1,114 +1,36 @@
 #pragma once
 
 #include <vector>
+#include <memory>
 #include "SFML/Graphics.hpp"
 
-//dimensions in 2D that are whole numbers
-struct Dim2Di
-{
-	int x, y;
-};
-
-//dimensions in 2D that are floating point numbers
-struct Dim2Df
-{
-	float x, y;
-};
-
-/*
-A box to put Games Constants in.
-These are special numbers with important meanings (screen width,
-ascii code for the escape key, number of lives a player starts with,
-the name of the title screen music track, etc.
-*/
-namespace GC
-{
-	//game play related constants to tweak
-	const Dim2Di SCREEN_RES{800,600};	//game window dimensions
-	const int FRAMERATE_MAX = 60;		//maximum framerate
-	const float SPEED = 250.f;			//ship speed
-	const float SCREEN_EDGE = 0.6f;		//how close to the edge the ship can get
-	const char ESCAPE_KEY{27};
-	const float ROCK_MIN_DIST = 2.15f;	//used when placing rocks to stop them getting too close
-	const int NUM_ROCKS = 500;			//how many to place
-	const int PLACE_TRIES = 10;			//how many times to try and place before giving up
-	const float ROCK_SPEED = 150.f;		//max speed of asteroids
-
-	const float BG_SPEED_MAX = 100.f;		//max speed of background sprites
-	const float BG_SPEED_MIN = 10.f;		//min speed of background sprites
-	const float BG_SCALE_MAX = 1.0f;		//max size of background sprites
-	const float BG_SCALE_MIN = 0.3f;		//min size of background sprites
-	const float BG_SCALE_RANGE = BG_SCALE_MAX - BG_SCALE_MIN;	//Difference between max and min background sprite sizes
-	const int BG_NUM_MAX = 24;				//maximum number of rng background images
-	const int BG_NUM_MIN = 12;				//minimum number of rng background images
-	const int BG_PNG_NUM = 8;				//8 background sprites on spritesheet
-	const int BG_PNG_RNG = 6;				//6 background sprites used dynamically
-	const Dim2Di BG_PNG_SIZE = {512,256};	//size (x,y) of background images
-	const Dim2Df BG_SCALE_RATIO = {			//scale ratio to fill screen
-		((float)SCREEN_RES.x / (float)BG_PNG_SIZE.x),
-		((float)SCREEN_RES.y / (float)BG_PNG_SIZE.y)
-	};
-	const float BG_Z_MAX = 32.f * BG_SCALE_RATIO.y;	//max depth (mountain base height)
-	const float BG_Z_FAR = 0.8f;					//Past this use a dark far away texture
-}
+#include "Sim.h"
+#include "SceneRender.h"
+#include "TextureCache.h"
+#include "AssetLoader.h"
+#include "ThreadPool.h"
+#include "Recording.h"
+#include "Config.h"
+#include "Snapshot.h"
 
 /*
 a background object
+Move only, the texture is shared by handle so moving one while sorting is cheap
 */
 struct Background
 {
 	float z = 0;						//faked 3D depth - done using parallax and scaling
 	float speed = GC::BG_SPEED_MIN;		//speed of this background object
-	sf::Texture tex;					//texture for sprite
+	TextureHandle tex;					//texture for sprite, shared with other layers using the same image (or the atlas)
 	sf::Sprite spr;						//image and position
 
-	void Update(sf::RenderWindow& window, float elapsed);
-};
-
-/*
-A game object that could be a rock or the player
-Objects are anything with a sprite that can move around the screen
-and collide with other objets.
-*/
-struct Object
-{
-	sf::Sprite spr;	//main image
-	float radius = 0;	//collision radius
-	enum class ObjectT { Ship, Rock, Bullet };	//what is this?
-	ObjectT type = ObjectT::Rock;
-	bool colliding = false; //did we hit something on the last update
-	bool active = false;	//should we be updating and rendering this one?
-	int health = 1;			//go inactive if health <= 0
+	Background() = default;
+	Background(Background&&) = default;
+	Background& operator=(Background&&) = default;
+	Background(const Background&) = delete;
+	Background& operator=(const Background&) = delete;
 
-	/*
-	Call this to setup your object
-	window - sfml render window
-	tex - texture to use on the sprite
-	type - what is it meant to be
-	*/
-	void Init(sf::RenderWindow& window, sf::Texture& tex, ObjectT type_);
-	//called by Init as needed
-	void InitShip(sf::RenderWindow& window, sf::Texture& tex);
-	//called by Init as needed
-	void InitRock(sf::RenderWindow& window, sf::Texture& tex);
-	//move and update logic
-	void Update(sf::RenderWindow& window, float elapsed, std::vector<Object>& objects, bool fire);
-	//draw
-	void Render(sf::RenderWindow& window);
-	//handle moving the ship around
-	void PlayerControl(const sf::Vector2u& screenSz, float elapsed, std::vector<Object>& objects, bool fire);
-	//rocks all move left, when leave the left edge of the screen they deactivate
-	void MoveRock(float elapsed);
-	//bullets move right
-	void MoveBullet(const sf::Vector2u& screenSz, float elapsed);
-	//called by Init to set up a bullet
-	void InitBullet(sf::RenderWindow& window, sf::Texture& tex);
-	//find an inactive bullet, activate it, set its position to start it flying
-	void FireBullet(const sf::Vector2f& pos, std::vector<Object>& objects);
-	//work out what to do when two objects hit each other
-	void Hit(Object& other);
-	//reduce health and then deactivate when it hits zero
-	void TakeDamage(int amount);
+	void Update(float elapsed);
 };
 
 /*
@@ -116,73 +38,67 @@ Manage the asteroid dodging game
 */
 struct Game
 {
-	sf::Texture texShip;
-	sf::Texture texRock;
-	sf::Texture texBullet;
-	std::vector<Object> objects;	//anything moving around
-	float spawnTimer = 0.f;				//a clock
-	float spawnDelay = 0.f;				//how long to wait before another asteroid comes in, decrease to make harder
-	float rockShipClearance = 2.f;	//when placing an asteroid, how many ship lengths away from other rocks should it be, harder = smaller
+	TextureCache textures;			//everything we've loaded, by path
+	std::unique_ptr<AssetLoader> loader;	//decodes images for textures when there's no bundle, null once they're all in
+	TextureRegion texShip;
+	TextureRegion texRock;
+	TextureRegion texBullet;
+	//image to use for each ObjectT
+	const TextureRegion& TextureFor(ObjectT type) const;
+	Sim sim;						//everything moving around, objects holds their sprites
+	std::vector<Object> objects;	//sprites for sim.ents, same index
+	bool debugCollisions = false;	//draw the collision radius and mark any collisions in red
+	int drawCalls = 0;				//draws made by the last Render
+	Rng rng;						//background layout, the simulation has its own
+	Recording recording;			//seed and every update's input, for replaying headless
+	bool recordInput = false;		//add each update to the recording
+	SnapshotRing history;			//the simulation before each of the last few updates, off in stress mode
+	std::unique_ptr<ThreadPool> threads;	//shared by the simulation and background scrolling, null when single threaded
+	GameConfig cfg;					//pool sizes and how many background layers, set by Init
 
-	sf::Texture texBgSky;			//Sky texture
-	sf::Texture texBgGround;		//Ground texture
-	sf::Texture texBgCloud1;		//Cloud texture
-	sf::Texture texBgCloud2;		//Cloud texture
-	sf::Texture texBgMount1;		//Mountain texture
-	sf::Texture texBgMount2;		//Mountain texture
-	sf::Texture texBgMount3;		//Mountain texture
-	sf::Texture texBgMount4;		//Mountain texture
 	std::vector<Background> backgrounds;	//parallax backgrounds
 
-	//initialize Backgrounds
+	//load every background image into the texture cache
 	void GenerateBgTextures();
+	//give a background layer its image from the cache
+	void SetBgImage(Background& bg, const std::string& file);
 	//Generates the randomized parallax background
 	void GenerateBgRandom();
-	//load textures, create ship and rocks, set all rocks initially inactive
-	void Init(sf::RenderWindow& window);
-	//move the ship and rocks, spawn new rocks 
-	void Update(sf::RenderWindow& window, float elapsed, bool fire);
-	//draw everything
-	void Render(sf::RenderWindow& window);
+	/*
+	start loading textures, create ship and rocks, set all rocks initially inactive
+	Images not in a bundle arrive over the next few frames (see UpdateAssets), the
+	game can run and draw in the meantime
+	seed - the same seed and inputs always play out the same way
+	cfg_ - capacities, in stress mode the world grows to fit the rocks and is scaled to fit the window
+	*/
+	void Init(sf::RenderWindow& window, uint32_t seed, const GameConfig& cfg_ = GameConfig());
+	//give any entities the simulation has grown into a sprite
+	void AddObjects();
+	//upload any images that have finished decoding, once a frame, true once they're all in
+	bool UpdateAssets();
+	//spread updates over this many threads (including the main one), 1 turns it off
+	void SetThreads(int numThreads);
+	//one fixed step of the simulation - move the ship and rocks, spawn new rocks
+	void Update(float elapsed, const Input& input);
+	/*
+	put the simulation back as it was updates ago, or as far as the history goes
+	the recording loses the updates rewound over, returns false if there's no history
+	*/
+	bool Rewind(int updates);
+	//write out the recording with a hash of where the simulation ended up
+	bool SaveRecording(const std::string& file);
+	//scroll the backgrounds, they're only for show so this runs once per drawn frame
+	void UpdateBackgrounds(float elapsed);
+	/*
+	draw everything, a whole frame from Begin to End
+	r - where to draw, the textures are sf::Textures so an SfmlRenderer
+	alpha - 0 to 1, how far we are from the last simulation update to the next
+	*/
+	void Render(RenderBackend& r, float alpha);
 };
 
-/*
-Update every object to see if it is colliding with any other - sets the colliding flag true
-objects - any could be colliding
-debug - if true, draw the collision radius and mark any collisions in red
-*/
-void CheckCollisions(std::vector<Object>& objects, sf::RenderWindow& window, bool debug = true);
-
-/*
-Draws circle for debugging
-*/
-void DrawCircle(sf::RenderWindow& window, const sf::Vector2f& pos, float radius, sf::Color col);
-
 /*
 file - path and file name and extension
 tex - set this up with the texture
 */
 bool LoadTexture(const std::string& file, sf::Texture& tex);
-
-/*
-Check if two circles are touching
-pos1,pos2 - two centres
-minDist - minimum colliding distance
-*/
-bool CircleToCircle(const sf::Vector2f& pos1, const sf::Vector2f& pos2, float minDist);
-
-/*
-Test one object against an array of other objects to see if it collides
-It's OK if the object happens to be in the array, it won't test against itself
-*/
-bool IsColliding(Object& obj, std::vector<Object>& objects);
-
-/*
-Setup a new rock to fly in from the right
-Look through the objects array, find an inactive rock, pick a new starting position
-for it just off screen to the right. Check it is at least extraClearance units away
-from anything else and mark active.
-If it does collide with something then don't spawn and return false.
-*/
-bool SpawnRock(sf::RenderWindow& window, std::vector<Object>& objects, float extraClearance);
-#pragma once
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+//dimensions in 2D that are whole numbers
+struct Dim2Di
+{
+	int x, y;
+};
+
+//dimensions in 2D that are floating point numbers
+struct Dim2Df
+{
+	float x, y;
+};
+
+/*
+A box to put Games Constants in.
+These are special numbers with important meanings (screen width,
+ascii code for the escape key, number of lives a player starts with,
+the name of the title screen music track, etc.
+*/
+namespace GC
+{
+	//game play related constants to tweak
+	const Dim2Di SCREEN_RES{800,600};	//game window dimensions
+	const int FRAMERATE_MAX = 60;		//maximum framerate
+	const float TICK_RATE = 60.f;		//default simulation updates per second, drawing runs at its own rate
+	const int MAX_TICKS_PER_FRAME = 5;	//after a long hitch drop the extra time rather than spiral trying to catch up
+	const int REWIND_HISTORY = 180;		//updates of snapshots kept to rewind through, 3 seconds at the default tick rate
+	const int REWIND_STEP = 60;			//updates one press of rewind goes back
+	const int ASSET_UPLOADS_PER_FRAME = 2;	//most decoded images sent to the GPU in one frame while loading, so a frame never stalls on all of them
+	const float SPEED = 250.f;			//ship speed
+	const float SCREEN_EDGE = 0.6f;		//how close to the edge the ship can get
+	const char ESCAPE_KEY{27};
+	const float ROCK_MIN_DIST = 2.15f;	//used when placing rocks to stop them getting too close
+	const int NUM_ROCKS = 500;			//default rock pool and how many to place, see SimConfig to change it at runtime
+	const int NUM_BULLETS = 50;			//default most bullets in flight at once
+	const int STRESS_ROCKS_MAX = 1000000;	//largest stress mode
+	const int ROCKS_MAX = STRESS_ROCKS_MAX;	//largest the rock pool can start at or grow to, buffers are sized for it up front
+	const int BULLETS_MAX = 100000;		//same for the bullet pool
+	const float STRESS_AREA_PER_ROCK = 6000.f;	//world area per rock in stress mode, about 10x an average rock
+	const int PLACE_TRIES = 10;			//how many times to try and place before giving up
+	const float ROCK_RADIUS_MIN = 10.f;	//smallest rock collision radius
+	const int ROCK_RADIUS_RANGE = 30;	//rocks are up to this much bigger
+	const float ROCK_SPEED = 150.f;		//max speed of asteroids
+	const float BULLET_SPEED = 250.f;	//how fast bullets fly right
+	const float SHIP_SCALE = 0.2f;		//ship sprite scale, its collision size comes from this
+	const Dim2Df HEADLESS_SHIP_SIZE{ 40.f, 50.f };	//ship size to use when there's no texture to measure
+	const int ROCK_TEX_SIZE = 96;		//width and height of a rock on its texture
+	const int BULLET_TEX_SIZE = 32;		//width and height of a bullet on its texture
+	const float BULLET_SCALE = 0.5f;	//bullet sprite scale
+
+	const float BG_SPEED_MAX = 100.f;		//max speed of background sprites
+	const float BG_SPEED_MIN = 10.f;		//min speed of background sprites
+	const float BG_SCALE_MAX = 1.0f;		//max size of background sprites
+	const float BG_SCALE_MIN = 0.3f;		//min size of background sprites
+	const float BG_SCALE_RANGE = BG_SCALE_MAX - BG_SCALE_MIN;	//Difference between max and min background sprite sizes
+	const int BG_NUM_MAX = 24;				//maximum number of rng background images
+	const int BG_NUM_MIN = 12;				//minimum number of rng background images
+	const int BG_PNG_NUM = 8;				//8 background sprites on spritesheet
+	const int BG_PNG_RNG = 6;				//6 background sprites used dynamically
+	const Dim2Di BG_PNG_SIZE = {512,256};	//size (x,y) of background images
+	const Dim2Df BG_SCALE_RATIO = {			//scale ratio to fill screen
+		((float)SCREEN_RES.x / (float)BG_PNG_SIZE.x),
+		((float)SCREEN_RES.y / (float)BG_PNG_SIZE.y)
+	};
+	const float BG_Z_MAX = 32.f * BG_SCALE_RATIO.y;	//max depth (mountain base height)
+	const float BG_Z_FAR = 0.8f;					//Past this use a dark far away texture
+}
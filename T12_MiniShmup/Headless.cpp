@@ -0,0 +1,375 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "Sim.h"
+#include "CircleKernel.h"
+#include "ThreadPool.h"
+#include "Recording.h"
+#include "Profiler.h"
+#include "SceneRender.h"
+#include "SoftRenderer.h"
+#include "Config.h"
+#include "FramePacer.h"
+#include "BatchRunner.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+/*
+Run the simulation with no window and report how long each update took.
+Usage: T12_Headless [-frames N] [-dt seconds] [-seed N] [-brute] [-threads N]
+	[-record file] [-replay file] [-perframe] [-trace file] [-render null|soft] [-circles] [-image file]
+	[-pace fps] [-sleep-slop us] [-rollback N]
+	[-config file] [-rocks N] [-max-rocks N] [-bullets N] [-max-bullets N] [-stress N] [-swept 0|1]
+	[-spawn-delay s] [-rock-clearance N] [-rock-speed N]
+The state hash at the end should match whatever the thread count.
+-record saves the scripted run, -replay plays back a recording (from here
+or the game) instead of the script and checks it ends in the same state.
+-perframe prints every update's time so two builds can be compared frame by frame.
+-trace writes the profiler's events as a Chrome trace and prints time per stage.
+-render draws every update through the same code as the game, into a counting
+null renderer or the software rasterizer, and times it separately. -circles adds
+the debug collision circles, -image saves the last frame as a PPM.
+The last lines set the entity pools and balancing (see Config.h). -stress N starts with N
+rocks scattered over a world grown to keep them as dense as the normal game,
+with -trace it shows how each stage scales with the number of entities.
+-swept 0 goes back to only testing where things end up each update, compare
+the two with a long -dt to see things pass through each other.
+-pace puts every frame through a FramePacer on a simulated clock, moved on by
+the time each frame's work really took, and prints how well it held fps.
+-sleep-slop makes the simulated OS oversleep by that much every time.
+Built with T12_TRACK_ALLOCS it prints how many heap allocations the frames
+made and which frame was the last to make any, -perframe adds a column.
+-rollback snapshots the simulation before every update and after each one
+rolls back N updates and runs them again, as rollback netcode would on a late
+input. It checks the re-run ends where the first one did and times the
+snapshots and the rollbacks.
+*/
+
+/*
+Placeholder image for the software renderer, a filled ellipse on transparent
+*/
+SoftTexture MakeDisc(int width, int height, RenderColor col)
+{
+	SoftTexture tex;
+	tex.width = width;
+	tex.height = height;
+	tex.rgba.resize((size_t)width * height * 4);
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+		{
+			const float dx = (x + 0.5f) / width * 2.f - 1.f, dy = (y + 0.5f) / height * 2.f - 1.f;
+			uint8_t* p = &tex.rgba[((size_t)y * width + x) * 4];
+			p[0] = col.r;
+			p[1] = col.g;
+			p[2] = col.b;
+			p[3] = dx * dx + dy * dy <= 1.f ? col.a : 0;
+		}
+	return tex;
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = 10000;
+	float dt = 1.f / GC::FRAMERATE_MAX;
+	unsigned int seed = 1;
+	bool brute = false;
+	int numThreads = 1;
+	const char* recordFile = nullptr;
+	const char* replayFile = nullptr;
+	bool perFrame = false;
+	const char* traceFile = nullptr;
+	const char* renderMode = nullptr;
+	bool circles = false;
+	const char* imageFile = nullptr;
+	float paceFps = 0;
+	int64_t sleepSlopUs = 0;
+	int rollbackFrames = 0;
+	GameConfig cfg;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-frames") && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-dt") && i + 1 < argc)
+			dt = (float)atof(argv[++i]);
+		else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+			seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "-brute"))
+			brute = true;
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-record") && i + 1 < argc)
+			recordFile = argv[++i];
+		else if (!strcmp(argv[i], "-replay") && i + 1 < argc)
+			replayFile = argv[++i];
+		else if (!strcmp(argv[i], "-perframe"))
+			perFrame = true;
+		else if (!strcmp(argv[i], "-trace") && i + 1 < argc)
+			traceFile = argv[++i];
+		else if (!strcmp(argv[i], "-render") && i + 1 < argc && (!strcmp(argv[i + 1], "null") || !strcmp(argv[i + 1], "soft")))
+			renderMode = argv[++i];
+		else if (!strcmp(argv[i], "-circles"))
+			circles = true;
+		else if (!strcmp(argv[i], "-image") && i + 1 < argc)
+			imageFile = argv[++i];
+		else if (!strcmp(argv[i], "-pace") && i + 1 < argc && atof(argv[i + 1]) > 0)
+			paceFps = (float)atof(argv[++i]);
+		else if (!strcmp(argv[i], "-sleep-slop") && i + 1 < argc)
+			sleepSlopUs = atoll(argv[++i]);
+		else if (!strcmp(argv[i], "-rollback") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			rollbackFrames = atoi(argv[++i]);
+		else if (!ParseConfigArg(argc, argv, i, cfg))
+		{
+			printf("Usage: %s [-frames N] [-dt seconds] [-seed N] [-brute] [-threads N] [-record file] [-replay file] [-perframe] [-trace file] [-render null|soft] [-circles] [-image file] [-pace fps] [-sleep-slop us] [-rollback N] %s\n",
+				argv[0], CONFIG_USAGE);
+			return EXIT_FAILURE;
+		}
+	}
+	if (frames <= 0 || dt <= 0 || numThreads <= 0)
+	{
+		printf("frames, dt and threads must be positive\n");
+		return EXIT_FAILURE;
+	}
+
+	Recording rec;
+	if (replayFile)
+	{
+		if (!rec.Load(replayFile) || rec.NumFrames() == 0)
+		{
+			printf("Couldn't load recording %s\n", replayFile);
+			return EXIT_FAILURE;
+		}
+		frames = (int)rec.NumFrames();
+	}
+	else
+	{
+		cfg.Validate();
+		const Dim2Df screenSz{ (float)GC::SCREEN_RES.x, (float)GC::SCREEN_RES.y };
+		rec.Start(seed, StressWorldSize(screenSz, cfg.sim.stressRocks), GC::HEADLESS_SHIP_SIZE, cfg.sim);
+	}
+
+	//threads before Init so it sizes a buffer for each task
+	Sim sim;
+	unique_ptr<ThreadPool> pool;
+	if (numThreads > 1)
+		pool.reset(new ThreadPool(numThreads));
+	sim.threads = pool.get();
+	sim.Init(rec.worldSz, rec.shipSz, rec.seed, rec.cfg);
+	sim.bruteCollisions = brute;
+
+	//drawing, placeholder textures the same size as the game's images
+	unique_ptr<SoftRenderer> renderer;
+	SoftTexture texShip, texRock, texBullet;
+	vector<Object> objects;
+	if (renderMode)
+	{
+		//a stress world is shrunk to fit the screen
+		renderer.reset(new SoftRenderer(min((int)rec.worldSz.x, GC::SCREEN_RES.x), min((int)rec.worldSz.y, GC::SCREEN_RES.y),
+			strcmp(renderMode, "soft") == 0));
+		//the ship image is on its side
+		texShip = MakeDisc((int)(rec.shipSz.y / GC::SHIP_SCALE), (int)(rec.shipSz.x / GC::SHIP_SCALE), RenderColor{ 200, 200, 255, 255 });
+		texRock = MakeDisc(GC::ROCK_TEX_SIZE, GC::ROCK_TEX_SIZE, RenderColor{ 140, 110, 90, 255 });
+		texBullet = MakeDisc(GC::BULLET_TEX_SIZE, GC::BULLET_TEX_SIZE, RenderColor{ 255, 220, 60, 255 });
+	}
+	//sprites for any entities there aren't any for yet, the pools can grow
+	auto addObjects = [&] {
+		objects.reserve(sim.ents.Size());
+		for (size_t i = objects.size(); i < sim.ents.Size(); ++i)
+		{
+			const SoftTexture& tex = sim.ents.type[i] == ObjectT::Ship ? texShip : sim.ents.type[i] == ObjectT::Rock ? texRock : texBullet;
+			objects.emplace_back(&tex, RenderRect{ 0, 0, tex.width, tex.height }, sim.ents, i);
+		}
+	};
+
+	SimClock paceClock;
+	paceClock.sleepSlop = sleepSlopUs * 1000;
+	FramePacer pacer;
+	pacer.Start(paceClock, paceFps);
+
+	//update f's input, from the recording or the script
+	auto frameInput = [&](int f, float& frameDt) {
+		frameDt = replayFile ? rec.dts[f] : dt;
+		return replayFile ? rec.GetInput(f) : ScriptedInput(f);
+	};
+	SnapshotRing history;
+	history.Resize(rollbackFrames, sim.ents.Size());
+
+	ProfileReset();
+	vector<double> times(frames);
+	vector<double> renderTimes(renderMode ? frames : 0);
+	vector<double> snapTimes(rollbackFrames ? frames : 0), rollbackTimes(rollbackFrames ? frames : 0);
+	size_t numRollbacks = 0;
+	FrameAllocs frameAllocs(frames);
+	typedef chrono::steady_clock Clock;
+	const Clock::time_point start = Clock::now();
+	for (int f = 0; f < frames; ++f)
+	{
+		frameAllocs.BeginFrame();
+		float frameDt;
+		const Input input = frameInput(f, frameDt);
+		if (recordFile && !replayFile)
+			rec.Add(frameDt, input);
+		if (rollbackFrames)
+		{
+			const Clock::time_point s0 = Clock::now();
+			history.Push(sim);
+			snapTimes[f] = chrono::duration<double, micro>(Clock::now() - s0).count();
+		}
+		const Clock::time_point t0 = Clock::now();
+		sim.Update(frameDt, input);
+		const Clock::time_point t1 = Clock::now();
+		times[f] = chrono::duration<double, micro>(t1 - t0).count();
+
+		if (renderer)
+		{
+			addObjects();
+			renderer->Begin();
+			renderer->SetView(rec.worldSz.x, rec.worldSz.y);
+			for (size_t i = 0; i < objects.size(); ++i)
+				objects[i].Render(*renderer, sim.ents, i, 1.f);
+			if (circles)
+				DrawCollisions(*renderer, sim.ents);
+			renderer->End();
+			renderTimes[f] = chrono::duration<double, micro>(Clock::now() - t1).count();
+		}
+		if (rollbackFrames && f + 1 >= rollbackFrames)
+		{
+			const uint64_t before = HashState(sim.ents);
+			const Clock::time_point r0 = Clock::now();
+			const uint32_t from = sim.frame - rollbackFrames;
+			if (!history.Rollback(sim, from))
+			{
+				printf("rollback FAILED, no snapshot of update %u held\n", from);
+				return EXIT_FAILURE;
+			}
+			for (int g = (int)from; g <= f; ++g)
+			{
+				float againDt;
+				const Input again = frameInput(g, againDt);
+				history.Push(sim);
+				sim.Update(againDt, again);
+			}
+			rollbackTimes[numRollbacks++] = chrono::duration<double, micro>(Clock::now() - r0).count();
+			if (HashState(sim.ents) != before)
+			{
+				printf("rollback DIVERGED re-running updates %u to %d\n", from, f);
+				return EXIT_FAILURE;
+			}
+		}
+		if (paceFps > 0)
+		{
+			paceClock.Advance(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - t0).count());
+			pacer.Wait();
+		}
+		frameAllocs.EndFrame();
+	}
+	const double totalMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+	const uint64_t hash = HashState(sim.ents);
+	if (perFrame)
+	{
+		printf("frame,us%s%s\n", renderer ? ",render_us" : "", AllocTracking() ? ",allocs" : "");
+		for (int f = 0; f < frames; ++f)
+		{
+			printf("%d,%.3f", f, times[f]);
+			if (renderer)
+				printf(",%.3f", renderTimes[f]);
+			if (AllocTracking())
+				printf(",%u", frameAllocs.counts[f]);
+			printf("\n");
+		}
+	}
+
+	int active = 0;
+	for (size_t i = 0; i < sim.ents.Size(); ++i)
+		if (sim.ents.Active(i))
+			++active;
+
+	sort(times.begin(), times.end());
+	if (replayFile)
+		printf("replay      %s, seed %u\n", replayFile, rec.seed);
+	else
+		printf("seed        %u\n", rec.seed);
+	printf("frames      %d at dt %.4fs (%s %s collisions, %s kernel, %d threads)\n", frames, replayFile ? rec.dts[0] : dt,
+		sim.cfg.swept ? "swept" : "discrete", brute ? "brute force" : "grid", CircleKernelName(), numThreads);
+	printf("total       %.2f ms, %.0f frames/sec\n", totalMs, frames / (totalMs / 1000.0));
+	printf("per frame   min %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us\n",
+		times[0], times[frames / 2], times[(size_t)(frames * 0.99)], times[frames - 1]);
+	if (renderer)
+	{
+		sort(renderTimes.begin(), renderTimes.end());
+		printf("render      %s, p50 %.2f us, p99 %.2f us, max %.2f us\n", renderMode,
+			renderTimes[frames / 2], renderTimes[(size_t)(frames * 0.99)], renderTimes[frames - 1]);
+		printf("submitted   %.1f sprites, %.1f circles, %.1f draws, %.0f pixels per frame\n",
+			renderer->sprites / (double)frames, renderer->circles / (double)frames,
+			renderer->drawCalls / (double)frames, renderer->pixelsDrawn / (double)frames);
+		if (renderer->rasterize)
+			printf("image       hash %016llx\n", (unsigned long long)renderer->Hash());
+		if (imageFile)
+		{
+			if (renderer->SavePPM(imageFile))
+				printf("image       %s\n", imageFile);
+			else
+				printf("Couldn't write image %s\n", imageFile);
+		}
+	}
+	printf("end state   %d active, ship %s, hash %016llx\n", active, sim.ents.Active(0) ? "alive" : "destroyed",
+		(unsigned long long)hash);
+	if (AllocTracking())
+		frameAllocs.Print(stdout);
+	printf("pools       %zu rocks (max %d), %zu bullets (max %d), world %.0f x %.0f\n",
+		sim.ents.pools[(int)ObjectT::Rock].total, sim.cfg.maxRocks, sim.ents.pools[(int)ObjectT::Bullet].total,
+		sim.cfg.maxBullets, rec.worldSz.x, rec.worldSz.y);
+
+	if (rollbackFrames)
+	{
+		sort(snapTimes.begin(), snapTimes.end());
+		rollbackTimes.resize(numRollbacks);
+		sort(rollbackTimes.begin(), rollbackTimes.end());
+		printf("snapshot    %zu bytes for %zu entities, p50 %.2f us, p99 %.2f us\n", history.Get(0)->data.size(),
+			sim.ents.Size(), snapTimes[snapTimes.size() / 2], snapTimes[(size_t)(snapTimes.size() * 0.99)]);
+		if (!rollbackTimes.empty())
+			printf("rollback    %d updates %zu times, all matched, p50 %.2f us, p99 %.2f us\n", rollbackFrames,
+				rollbackTimes.size(), rollbackTimes[rollbackTimes.size() / 2], rollbackTimes[(size_t)(rollbackTimes.size() * 0.99)]);
+	}
+	if (paceFps > 0)
+	{
+		printf("paced       %.1f fps on a simulated clock, sleeps %lld us late, spin margin ended at %.2f ms\n",
+			paceFps, (long long)sleepSlopUs, pacer.spinMargin / 1e6);
+		pacer.stats.Print(stdout);
+	}
+	if (traceFile)
+	{
+		if (ProfileWriteChromeTrace(traceFile))
+			printf("trace       %s\n", traceFile);
+		else
+			printf("Couldn't write trace %s\n", traceFile);
+		ProfilePrintSummary(stdout);
+	}
+	if (recordFile)
+	{
+		rec.endHash = hash;
+		if (!rec.Save(recordFile))
+		{
+			printf("Couldn't write recording %s\n", recordFile);
+			return EXIT_FAILURE;
+		}
+		printf("recorded    %s\n", recordFile);
+	}
+	if (replayFile && rec.endHash)
+	{
+		if (rec.endHash != hash)
+		{
+			printf("replay DIVERGED from the recording (expected hash %016llx)\n", (unsigned long long)rec.endHash);
+			return EXIT_FAILURE;
+		}
+		printf("replay matches the recording\n");
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include <assert.h>
+#include <algorithm>
+
+#include "InputState.h"
+
+using namespace std;
+using namespace sf;
+
+const size_t INPUTS_IN_FLIGHT = 64;		//inputs between being polled and shown, more is only a burst of mashing
+const size_t LATENCY_SAMPLES = 1 << 16;	//inputs measured, over an hour of play
+
+InputState::InputState()
+{
+	waiting.reserve(INPUTS_IN_FLIGHT);
+	taken.reserve(INPUTS_IN_FLIGHT);
+	latencies.reserve(LATENCY_SAMPLES);
+}
+
+bool InputState::HandleEvent(const Event& event, int64_t now)
+{
+	if (event.type == Event::LostFocus)
+	{
+		ReleaseAll(now);
+		return true;
+	}
+	if (event.type != Event::KeyPressed && event.type != Event::KeyReleased)
+		return false;
+
+	const bool down = event.type == Event::KeyPressed;
+	bool* key = nullptr;
+	switch (event.key.code)
+	{
+	case Keyboard::Up:
+		key = &held.up;
+		break;
+	case Keyboard::Down:
+		key = &held.down;
+		break;
+	case Keyboard::Left:
+		key = &held.left;
+		break;
+	case Keyboard::Right:
+		key = &held.right;
+		break;
+	case Keyboard::Space:
+		//only the press matters, it stays set until an update takes it
+		if (!down)
+			return true;
+		key = &held.fire;
+		break;
+	default:
+		return false;
+	}
+
+	//repeats and presses we already know about change nothing an update would see
+	if (*key != down)
+	{
+		*key = down;
+		waiting.push_back(now);
+	}
+	return true;
+}
+
+void InputState::ReleaseAll(int64_t now)
+{
+	if (held.up || held.down || held.left || held.right)
+		waiting.push_back(now);
+	held.up = held.down = held.left = held.right = false;
+}
+
+Input InputState::Take()
+{
+	Input input = held;
+	held.fire = false;
+	taken.insert(taken.end(), waiting.begin(), waiting.end());
+	waiting.clear();
+	return input;
+}
+
+void InputState::Displayed(int64_t now)
+{
+	for (size_t i = 0; i < taken.size(); ++i)
+	{
+		assert(now >= taken[i]);
+		latencies.push_back((now - taken[i]) / 1000.f);
+	}
+	taken.clear();
+}
+
+void InputState::PrintLatency(FILE* out) const
+{
+	if (latencies.empty())
+	{
+		fprintf(out, "Input to display: no inputs\n");
+		return;
+	}
+	vector<float> sorted = latencies;
+	sort(sorted.begin(), sorted.end());
+	float total = 0;
+	for (size_t i = 0; i < sorted.size(); ++i)
+		total += sorted[i];
+	fprintf(out, "Input to display: %zu inputs, mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+		sorted.size(), total / sorted.size(), sorted[sorted.size() / 2],
+		sorted[(size_t)(sorted.size() * 0.99)], sorted.back());
+}
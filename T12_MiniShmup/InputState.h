@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+#include "Sim.h"
+
+/*
+The player's keys, kept up to date from window events instead of asking
+the keyboard every update. Fire goes off on the press rather than the
+release and is held until an update takes it, so a tap between two
+updates isn't lost.
+
+Every event that changes what an update would see is timestamped. When an
+update takes the snapshot those times go with it, and the next displayed
+frame (the first that can show the effect) records the gap as a latency
+sample. Times are when the event was polled, not when the key moved, so
+the delay before the next poll is in the numbers but the OS's isn't.
+*/
+struct InputState
+{
+	Input held;							//movement keys down now, fire set while a press is waiting for an update
+	std::vector<int64_t> waiting;		//when each input not yet taken by an update happened, microseconds
+	std::vector<int64_t> taken;			//same for inputs taken by an update that haven't been displayed yet
+	std::vector<float> latencies;		//milliseconds from input to display, one per input shown so far
+
+	//reserves for a long session up front so inputs don't allocate mid game
+	InputState();
+
+	/*
+	Apply a window event, returns false if it isn't one of ours
+	now - microseconds on the same clock Displayed gets
+	*/
+	bool HandleEvent(const sf::Event& event, int64_t now);
+	//window lost focus, let go of everything so keys released elsewhere don't stick
+	void ReleaseAll(int64_t now);
+	//the snapshot for one update, any fire press is used up
+	Input Take();
+	//a frame has just been shown, everything taken before it is now on screen
+	void Displayed(int64_t now);
+	//how many inputs were measured and the spread of their latency
+	void PrintLatency(FILE* out) const;
+};
@@ -0,0 +1,109 @@
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Placement.h"
+#include "Sim.h"
+#include "CircleKernel.h"
+
+using namespace std;
+
+void PlacementGrid::Reset(float minX, float minY, float maxX, float maxY, float cellSize_, size_t maxCells)
+{
+	assert(maxX >= minX && maxY >= minY && cellSize_ > 0);
+	cellSize = cellSize_;
+	const float area = ((maxX - minX) / cellSize + 1.f) * ((maxY - minY) / cellSize + 1.f);
+	if (area > (float)maxCells)
+		cellSize *= sqrtf(area / maxCells);
+	originX = minX;
+	originY = minY;
+	cols = (int)((maxX - minX) / cellSize) + 1;
+	rows = (int)((maxY - minY) / cellSize) + 1;
+	maxRadius = 0;
+	cellHead.assign((size_t)cols * rows, -1);
+	next.clear();
+	xs.clear();
+	ys.clear();
+	rs.clear();
+}
+
+int PlacementGrid::CellX(float x) const
+{
+	return min(max((int)floorf((x - originX) / cellSize), 0), cols - 1);
+}
+
+int PlacementGrid::CellY(float y) const
+{
+	return min(max((int)floorf((y - originY) / cellSize), 0), rows - 1);
+}
+
+void PlacementGrid::Insert(float x, float y, float r)
+{
+	const int c = CellY(y) * cols + CellX(x);
+	const int i = (int)xs.size();
+	xs.push_back(x);
+	ys.push_back(y);
+	rs.push_back(r);
+	next.push_back(cellHead[c]);
+	cellHead[c] = i;
+	maxRadius = max(maxRadius, r);
+}
+
+bool PlacementGrid::Overlaps(float x, float y, float r) const
+{
+	//edge cells hold anything clamped into them, so clamping the search finds those too
+	const float reach = r + maxRadius;
+	const int x0 = CellX(x - reach), x1 = CellX(x + reach);
+	const int y0 = CellY(y - reach), y1 = CellY(y + reach);
+	for (int cy = y0; cy <= y1; ++cy)
+		for (int cx = x0; cx <= x1; ++cx)
+			for (int i = cellHead[cy * cols + cx]; i >= 0; i = next[i])
+				if (CircleToCircle(x, y, xs[i], ys[i], r + rs[i]))
+					return true;
+	return false;
+}
+
+void SpawnQuery::Reset(const SpatialGrid* grid_)
+{
+	grid = grid_;
+	placed.clear();
+}
+
+void SpawnQuery::Reserve(size_t nearbyMax)
+{
+	placed.reserve(nearbyMax);
+	nearby.reserve(nearbyMax);
+}
+
+bool SpawnQuery::IsColliding(const Entities& ents, float x, float y, float radius, size_t skip)
+{
+	if (!grid)
+		return ::IsColliding(ents, x, y, radius, skip);
+
+	nearby.clear();
+	grid->Query(x, y, radius, nearby);
+	for (size_t i = 0; i < placed.size(); ++i)
+		nearby.push_back((int)placed[i]);
+
+	//pack the live ones into blocks for the same kernel IsColliding uses, so the
+	//arithmetic and so the answer is identical
+	float bx[CIRCLE_BLOCK_MAX], by[CIRCLE_BLOCK_MAX], br[CIRCLE_BLOCK_MAX];
+	size_t n = 0;
+	while (n < nearby.size())
+	{
+		int count = 0;
+		for (; count < CIRCLE_BLOCK_MAX && n < nearby.size(); ++n)
+		{
+			const size_t idx = (size_t)nearby[n];
+			if (idx == skip || !ents.Active(idx))
+				continue;
+			bx[count] = ents.x[idx];
+			by[count] = ents.y[idx];
+			br[count] = ents.radius[idx];
+			++count;
+		}
+		if (count && CircleOverlapMask(x, y, radius, bx, by, br, count))
+			return true;
+	}
+	return false;
+}
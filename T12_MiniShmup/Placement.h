@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+
+#include "Entities.h"
+#include "SpatialGrid.h"
+
+/*
+Finding room for new rocks without testing every entity.
+PlacementGrid is for bulk placement (PlaceRocks), circles are added as
+they're placed and each "is there room" only looks at nearby cells.
+SpawnQuery answers the same question while the game runs, from the grid
+the collision pass has just built.
+*/
+
+/*
+Uniform grid that circles can be added to one at a time, each cell keeps a
+linked list of the circles whose centres are in it
+Usage: Reset to cover an area, then Insert and Overlaps in any order.
+*/
+struct PlacementGrid
+{
+	float cellSize = 0;			//width and height of a cell
+	float originX = 0;			//world position of the top left cell
+	float originY = 0;
+	int cols = 0;				//grid dimensions in cells
+	int rows = 0;
+	float maxRadius = 0;		//largest circle added so far
+
+	std::vector<int> cellHead;	//first circle in each cell, -1 if empty
+	std::vector<int> next;		//next circle in the same cell, -1 at the end
+	std::vector<float> xs;		//circles added since the last Reset
+	std::vector<float> ys;
+	std::vector<float> rs;
+
+	/*
+	forget all circles and cover a new area
+	minX,minY,maxX,maxY - where centres will be, anything outside is clamped to the edge cells
+	cellSize_ - about the largest query plus radius, grown if the area would need more than maxCells
+	*/
+	void Reset(float minX, float minY, float maxX, float maxY, float cellSize_, size_t maxCells);
+	void Insert(float x, float y, float r);
+	//true if the circle touches anything added (distance <= r + theirs)
+	bool Overlaps(float x, float y, float r) const;
+
+private:
+	int CellX(float x) const;
+	int CellY(float y) const;
+};
+
+/*
+Is there room for an entity here, answered from a SpatialGrid built from
+every active entity (CheckCollisionsGrid's) instead of scanning them all.
+Entities placed after the grid was built aren't in it, so they're kept in
+a short list and tested directly. Gives exactly the same answer as
+IsColliding, so a brute force run and a grid run stay identical.
+*/
+struct SpawnQuery
+{
+	const SpatialGrid* grid = nullptr;	//null falls back to IsColliding
+	std::vector<size_t> placed;			//entities activated since the grid was built
+	std::vector<int> nearby;			//scratch for the grid query
+
+	//start again after grid_ has been rebuilt, or with none
+	void Reset(const SpatialGrid* grid_);
+	//make room for this many nearby entities (and placed ones) per query without allocating
+	void Reserve(size_t nearbyMax);
+	//same as IsColliding(ents, x, y, radius, skip)
+	bool IsColliding(const Entities& ents, float x, float y, float radius, size_t skip);
+	//remember an entity that was activated after the grid was built
+	void Placed(size_t idx) { placed.push_back(idx); }
+};
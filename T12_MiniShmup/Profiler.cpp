@@ -0,0 +1,160 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+#include "Profiler.h"
+
+using namespace std;
+
+static_assert((PROFILE_RING_SIZE & (PROFILE_RING_SIZE - 1)) == 0, "ring size must be a power of 2");
+
+/*
+A thread's events, only that thread writes. head counts every event ever
+recorded, so the live ones are the last min(head, PROFILE_RING_SIZE).
+Kept when the thread exits so a trace can still be written after it has
+gone, and handed on to the next new thread (which carries on under the
+same tid) so rebuilding a thread pool doesn't keep adding rings.
+*/
+struct ThreadProfile
+{
+	int tid = 0;
+	atomic<uint64_t> head{ 0 };
+	ProfileEvent events[PROFILE_RING_SIZE];
+};
+
+typedef chrono::steady_clock ProfileClock;
+static const ProfileClock::time_point profileEpoch = ProfileClock::now();
+
+static mutex threadsMtx;					//only taken when a thread records its first event, or to read
+static vector<unique_ptr<ThreadProfile>> threadProfiles;	//every ring, freed at exit
+static vector<ThreadProfile*> freeProfiles;		//rings of threads that have exited
+
+/*
+Holds this thread's ring and gives it back when the thread exits
+*/
+struct ThreadProfileOwner
+{
+	ThreadProfile* tp = nullptr;
+
+	~ThreadProfileOwner()
+	{
+		if (!tp)
+			return;
+		lock_guard<mutex> lock(threadsMtx);
+		freeProfiles.push_back(tp);
+	}
+};
+static thread_local ThreadProfileOwner thisThread;
+
+uint64_t ProfileNow()
+{
+	return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(ProfileClock::now() - profileEpoch).count();
+}
+
+void ProfileRecord(const char* name, uint64_t start, uint64_t end, uint64_t allocs)
+{
+	if (!thisThread.tp)
+	{
+		lock_guard<mutex> lock(threadsMtx);
+		if (!freeProfiles.empty())
+		{
+			thisThread.tp = freeProfiles.back();
+			freeProfiles.pop_back();
+		}
+		else
+		{
+			threadProfiles.emplace_back(new ThreadProfile);
+			thisThread.tp = threadProfiles.back().get();
+			thisThread.tp->tid = (int)threadProfiles.size() - 1;
+		}
+	}
+	ThreadProfile* tp = thisThread.tp;
+	const uint64_t h = tp->head.load(memory_order_relaxed);
+	ProfileEvent& e = tp->events[h & (PROFILE_RING_SIZE - 1)];
+	e.name = name;
+	e.start = start;
+	e.duration = end - start;
+	e.allocs = allocs;
+	tp->head.store(h + 1, memory_order_release);
+}
+
+/*
+Copy out the live events of one thread, oldest first
+*/
+void ReadRing(const ThreadProfile& tp, vector<ProfileEvent>& out)
+{
+	const uint64_t h = tp.head.load(memory_order_acquire);
+	const uint64_t first = h > PROFILE_RING_SIZE ? h - PROFILE_RING_SIZE : 0;
+	for (uint64_t i = first; i < h; ++i)
+		out.push_back(tp.events[i & (PROFILE_RING_SIZE - 1)]);
+}
+
+bool ProfileWriteChromeTrace(const string& path)
+{
+	FILE* f = fopen(path.c_str(), "w");
+	if (!f)
+		return false;
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	vector<ProfileEvent> events;
+	lock_guard<mutex> lock(threadsMtx);
+	for (size_t t = 0; t < threadProfiles.size(); ++t)
+	{
+		events.clear();
+		ReadRing(*threadProfiles[t], events);
+		for (size_t i = 0; i < events.size(); ++i)
+		{
+			//chrome wants microseconds
+			fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"allocs\":%llu}}",
+				first ? "" : ",\n", events[i].name, threadProfiles[t]->tid, events[i].start / 1000.0, events[i].duration / 1000.0,
+				(unsigned long long)events[i].allocs);
+			first = false;
+		}
+	}
+	fprintf(f, "\n]}\n");
+	return fclose(f) == 0;
+}
+
+void ProfilePrintSummary(FILE* out)
+{
+	//durations and allocations by stage name across every thread
+	map<string, vector<uint64_t>> stages;
+	map<string, uint64_t> allocs;
+	vector<ProfileEvent> events;
+	{
+		lock_guard<mutex> lock(threadsMtx);
+		for (size_t t = 0; t < threadProfiles.size(); ++t)
+			ReadRing(*threadProfiles[t], events);
+	}
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		stages[events[i].name].push_back(events[i].duration);
+		allocs[events[i].name] += events[i].allocs;
+	}
+
+	fprintf(out, "%-24s %8s %10s %10s %10s %10s\n", "stage", "calls", "p50 us", "p99 us", "total ms", "allocs");
+	for (map<string, vector<uint64_t>>::iterator it = stages.begin(); it != stages.end(); ++it)
+	{
+		vector<uint64_t>& d = it->second;
+		sort(d.begin(), d.end());
+		uint64_t total = 0;
+		for (size_t i = 0; i < d.size(); ++i)
+			total += d[i];
+		fprintf(out, "%-24s %8zu %10.2f %10.2f %10.2f %10llu\n", it->first.c_str(), d.size(),
+			d[d.size() / 2] / 1000.0, d[(size_t)(d.size() * 0.99)] / 1000.0, total / 1000000.0,
+			(unsigned long long)allocs[it->first]);
+	}
+}
+
+void ProfileReset()
+{
+	lock_guard<mutex> lock(threadsMtx);
+	for (size_t t = 0; t < threadProfiles.size(); ++t)
+		threadProfiles[t]->head.store(0, memory_order_release);
+}
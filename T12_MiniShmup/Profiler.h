@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+
+#include "AllocTracker.h"
+
+/*
+Frame profiler - PROFILE_SCOPE("name") times the rest of the enclosing
+block. Each thread writes finished scopes into its own fixed size ring
+(no locks, no allocation after the first event), the oldest events get
+overwritten once it's full. Read them back as a Chrome trace (load it in
+chrome://tracing or Perfetto) or a p50/p99 table per stage. With
+T12_TRACK_ALLOCS each scope also counts the heap allocations its thread
+made inside it.
+Build with T12_PROFILE=0 to compile every marker out.
+*/
+
+#ifndef T12_PROFILE
+#define T12_PROFILE 1
+#endif
+
+const uint32_t PROFILE_RING_SIZE = 1 << 16;	//events kept per thread, must be a power of 2
+
+/*
+One timed scope, times in nanoseconds since the profiler started
+name - must outlive the profiler, in practice a string literal
+*/
+struct ProfileEvent
+{
+	const char* name;
+	uint64_t start;
+	uint64_t duration;
+	uint64_t allocs;	//made by this thread inside the scope, 0 without T12_TRACK_ALLOCS
+};
+
+//nanoseconds since the profiler started
+uint64_t ProfileNow();
+//add a finished scope to this thread's ring
+void ProfileRecord(const char* name, uint64_t start, uint64_t end, uint64_t allocs = 0);
+
+/*
+Write every thread's events as Chrome trace event JSON
+Call it while the other threads are idle (e.g. between frames), a ring
+being written to at the same time can hand back a half written event
+*/
+bool ProfileWriteChromeTrace(const std::string& path);
+//print calls, p50, p99, total time and allocations for each stage, same caveat as above
+void ProfilePrintSummary(FILE* out);
+//forget everything recorded so far, e.g. to skip loading
+void ProfileReset();
+
+/*
+Times its own lifetime, use PROFILE_SCOPE rather than this directly
+*/
+struct ProfileScope
+{
+	const char* name;
+	uint64_t start;
+	uint64_t allocStart;
+
+	explicit ProfileScope(const char* name_) : name(name_), start(ProfileNow()), allocStart(ThreadAllocCount()) {}
+	~ProfileScope() { ProfileRecord(name, start, ProfileNow(), ThreadAllocCount() - allocStart); }
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#if T12_PROFILE
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
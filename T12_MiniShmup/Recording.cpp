@@ -0,0 +1,128 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <assert.h>
+#include <stdio.h>
+
+#include "Recording.h"
+
+using namespace std;
+
+uint8_t PackInput(const Input& input)
+{
+	uint8_t bits = 0;
+	if (input.up)
+		bits |= INPUT_UP;
+	if (input.down)
+		bits |= INPUT_DOWN;
+	if (input.left)
+		bits |= INPUT_LEFT;
+	if (input.right)
+		bits |= INPUT_RIGHT;
+	if (input.fire)
+		bits |= INPUT_FIRE;
+	return bits;
+}
+
+Input UnpackInput(uint8_t bits)
+{
+	Input input;
+	input.up = (bits & INPUT_UP) != 0;
+	input.down = (bits & INPUT_DOWN) != 0;
+	input.left = (bits & INPUT_LEFT) != 0;
+	input.right = (bits & INPUT_RIGHT) != 0;
+	input.fire = (bits & INPUT_FIRE) != 0;
+	return input;
+}
+
+void Recording::Start(uint32_t seed_, const Dim2Df& worldSz_, const Dim2Df& shipSz_, const SimConfig& cfg_)
+{
+	seed = seed_;
+	worldSz = worldSz_;
+	shipSz = shipSz_;
+	cfg = cfg_;
+	endHash = 0;
+	dts.clear();
+	inputs.clear();
+}
+
+void Recording::Add(float dt, const Input& input)
+{
+	dts.push_back(dt);
+	inputs.push_back(PackInput(input));
+}
+
+void Recording::Truncate(size_t numFrames)
+{
+	if (numFrames < dts.size())
+	{
+		dts.resize(numFrames);
+		inputs.resize(numFrames);
+	}
+}
+
+bool Recording::Save(const string& path) const
+{
+	assert(dts.size() == inputs.size());
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f)
+		return false;
+	RecordingHeader h;
+	h.magic = RECORDING_MAGIC;
+	h.version = RECORDING_VERSION;
+	h.seed = seed;
+	h.numFrames = (uint32_t)dts.size();
+	h.worldW = worldSz.x;
+	h.worldH = worldSz.y;
+	h.shipW = shipSz.x;
+	h.shipH = shipSz.y;
+	h.endHash = endHash;
+	h.rocks = cfg.rocks;
+	h.maxRocks = cfg.maxRocks;
+	h.bullets = cfg.bullets;
+	h.maxBullets = cfg.maxBullets;
+	h.stressRocks = cfg.stressRocks;
+	h.swept = cfg.swept;
+	h.spawnDelay = cfg.spawnDelay;
+	h.rockClearance = cfg.rockClearance;
+	h.rockSpeed = cfg.rockSpeed;
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+	if (ok && h.numFrames)
+	{
+		ok = fwrite(&dts[0], sizeof(float), dts.size(), f) == dts.size();
+		if (ok)
+			ok = fwrite(&inputs[0], 1, inputs.size(), f) == inputs.size();
+	}
+	return fclose(f) == 0 && ok;
+}
+
+bool Recording::Load(const string& path)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (!f)
+		return false;
+	RecordingHeader h;
+	bool ok = fread(&h, sizeof(h), 1, f) == 1 && h.magic == RECORDING_MAGIC && h.version == RECORDING_VERSION;
+	if (ok)
+	{
+		SimConfig hcfg;
+		hcfg.rocks = h.rocks;
+		hcfg.maxRocks = h.maxRocks;
+		hcfg.bullets = h.bullets;
+		hcfg.maxBullets = h.maxBullets;
+		hcfg.stressRocks = h.stressRocks;
+		hcfg.swept = h.swept;
+		hcfg.spawnDelay = h.spawnDelay;
+		hcfg.rockClearance = h.rockClearance;
+		hcfg.rockSpeed = h.rockSpeed;
+		Start(h.seed, Dim2Df{ h.worldW, h.worldH }, Dim2Df{ h.shipW, h.shipH }, hcfg);
+		endHash = h.endHash;
+		dts.resize(h.numFrames);
+		inputs.resize(h.numFrames);
+		if (h.numFrames)
+			ok = fread(&dts[0], sizeof(float), dts.size(), f) == dts.size() &&
+				fread(&inputs[0], 1, inputs.size(), f) == inputs.size();
+	}
+	fclose(f);
+	if (!ok)
+		Start(0, Dim2Df{ 0, 0 }, Dim2Df{ 0, 0 });
+	return ok;
+}
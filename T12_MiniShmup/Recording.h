@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "GameConstants.h"
+#include "Sim.h"
+
+/*
+Everything needed to play a run back exactly: the seed and sizes the
+simulation was set up with, then the dt and Input of every update.
+A simulation given the same seed and the same updates ends up in the
+same state, so a recording is a repeatable workload for comparing builds.
+Layout on disk (little endian):
+	RecordingHeader
+	float dt[numFrames]
+	uint8_t input[numFrames]	- Input packed by PackInput
+*/
+
+const uint32_t RECORDING_MAGIC = 0x52323154;	//"T12R"
+const uint32_t RECORDING_VERSION = 5;	//2 added the pool sizes, 3 swept collisions, 4 balancing, 5 colliding flags kept to the next update (end hashes changed)
+
+struct RecordingHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t seed;
+	uint32_t numFrames;
+	float worldW, worldH;	//Sim::Init arguments
+	float shipW, shipH;
+	uint64_t endHash;		//HashState after the last update, 0 if not known
+	int32_t rocks, maxRocks;	//SimConfig
+	int32_t bullets, maxBullets;
+	int32_t stressRocks;
+	int32_t swept;
+	float spawnDelay, rockClearance, rockSpeed;
+};
+
+//bits in a packed Input
+enum InputBits : uint8_t { INPUT_UP = 1, INPUT_DOWN = 2, INPUT_LEFT = 4, INPUT_RIGHT = 8, INPUT_FIRE = 16 };
+uint8_t PackInput(const Input& input);
+Input UnpackInput(uint8_t bits);
+
+/*
+A run of simulation updates, recorded as they happen or loaded for replay
+*/
+struct Recording
+{
+	uint32_t seed = 0;
+	Dim2Df worldSz{ 0, 0 };
+	Dim2Df shipSz{ 0, 0 };
+	SimConfig cfg;					//pool sizes and balancing the simulation was set up with
+	uint64_t endHash = 0;			//state hash at the end, checked by replays
+	std::vector<float> dts;			//elapsed time passed to each update
+	std::vector<uint8_t> inputs;	//packed Input for each update
+
+	//forget the frames and start again with this setup
+	void Start(uint32_t seed_, const Dim2Df& worldSz_, const Dim2Df& shipSz_, const SimConfig& cfg_ = SimConfig());
+	//one more update
+	void Add(float dt, const Input& input);
+	//drop every update from numFrames on, e.g. after rewinding
+	void Truncate(size_t numFrames);
+	size_t NumFrames() const { return dts.size(); }
+	Input GetInput(size_t frame) const { return UnpackInput(inputs[frame]); }
+
+	bool Save(const std::string& path) const;
+	//false if it's missing or not a valid recording
+	bool Load(const std::string& path);
+};
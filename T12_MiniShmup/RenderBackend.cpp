@@ -0,0 +1,35 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "RenderBackend.h"
+
+void SpriteCorners(const RenderSprite& spr, RenderVertex quad[4])
+{
+	//same corners and texture coordinates sf::Sprite uses
+	const float w = (float)abs(spr.texRect.width);
+	const float h = (float)abs(spr.texRect.height);
+	const float left = (float)spr.texRect.left;
+	const float right = left + spr.texRect.width;
+	const float top = (float)spr.texRect.top;
+	const float bottom = top + spr.texRect.height;
+	const float lx[4] = { 0, 0, w, w };
+	const float ly[4] = { 0, h, h, 0 };
+	const float u[4] = { left, left, right, right };
+	const float v[4] = { top, bottom, bottom, top };
+
+	//scale and rotate about the origin then move it to x,y, as sf::Transformable does
+	const float angle = -spr.rotation * 3.14159265f / 180.f;
+	const float cosine = cosf(angle), sine = sinf(angle);
+	const float sxc = spr.scaleX * cosine, syc = spr.scaleY * cosine;
+	const float sxs = spr.scaleX * sine, sys = spr.scaleY * sine;
+	const float tx = -spr.originX * sxc - spr.originY * sys + spr.x;
+	const float ty = spr.originX * sxs - spr.originY * syc + spr.y;
+	for (int i = 0; i < 4; ++i)
+	{
+		quad[i].x = sxc * lx[i] + sys * ly[i] + tx;
+		quad[i].y = -sxs * lx[i] + syc * ly[i] + ty;
+		quad[i].u = u[i];
+		quad[i].v = v[i];
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+What the game draws with, so the same drawing code can go to a window
+(SfmlRenderer) or stay on the CPU with no display at all (SoftRenderer).
+Three things can be submitted: sprites, free form textured quads and
+debug circles. Nothing here knows about SFML.
+Usage: Begin, submit, End, in painter's order (later on top).
+*/
+
+/*
+A backend's own texture - an sf::Texture* for SfmlRenderer, a SoftTexture*
+for SoftRenderer. Null draws untextured in the submitted colour.
+*/
+typedef const void* RenderTex;
+
+struct RenderColor
+{
+	uint8_t r, g, b, a;
+};
+const RenderColor RENDER_WHITE{ 255, 255, 255, 255 };
+const RenderColor RENDER_RED{ 255, 0, 0, 255 };
+const RenderColor RENDER_GREEN{ 0, 255, 0, 255 };
+
+//area of a texture in pixels
+struct RenderRect
+{
+	int left, top, width, height;
+};
+
+//a quad corner, position on screen and texture coordinates in pixels
+struct RenderVertex
+{
+	float x, y;
+	float u, v;
+};
+
+/*
+A texture rectangle placed on screen, meaning the same as an sf::Sprite:
+scaled and rotated about origin, which then lands on x,y
+*/
+struct RenderSprite
+{
+	RenderTex tex = nullptr;
+	RenderRect texRect{ 0, 0, 0, 0 };
+	float originX = 0, originY = 0;	//in texture pixels from the rect's top left
+	float scaleX = 1, scaleY = 1;
+	float rotation = 0;				//degrees clockwise
+	float x = 0, y = 0;				//screen position of the origin
+	RenderColor color = RENDER_WHITE;	//multiplies the texture
+};
+
+struct RenderBackend
+{
+	virtual ~RenderBackend() {}
+
+	//start a frame, clears to black and goes back to one unit per pixel
+	virtual void Begin() = 0;
+	//stretch 0,0 to width,height over the whole target for what's submitted from now on, e.g. to fit a big world on screen
+	virtual void SetView(float width, float height) = 0;
+	virtual void DrawSprite(const RenderSprite& spr) = 0;
+	//quad - corners in the order top left, bottom left, bottom right, top right
+	virtual void DrawQuad(RenderTex tex, const RenderVertex quad[4], RenderColor col) = 0;
+	//a 2 pixel outline just outside radius, for debugging
+	virtual void DrawCircle(float x, float y, float radius, RenderColor col) = 0;
+	//finish the frame, returns how many draw calls it took
+	virtual int End() = 0;
+};
+
+//where a sprite's corners end up, in the order DrawQuad takes them
+void SpriteCorners(const RenderSprite& spr, RenderVertex quad[4]);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*
+Small, fast random number generator (PCG32) owned by whoever needs it,
+instead of the global rand(). The same seed always gives the same numbers
+on every platform, so a seed plus the player's input replays a run exactly.
+*/
+struct Rng
+{
+	uint64_t state = 0x853c49e6748fea9bull;
+
+	//restart the sequence
+	void Seed(uint64_t s)
+	{
+		state = 0;
+		Next();
+		state += s;
+		Next();
+	}
+	//32 random bits
+	uint32_t Next()
+	{
+		const uint64_t old = state;
+		state = old * 6364136223846793005ull + 1442695040888963407ull;
+		const uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+		const uint32_t rot = (uint32_t)(old >> 59);
+		return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+	}
+	//0 to n-1, n must be above 0
+	uint32_t Below(uint32_t n) { return (uint32_t)(((uint64_t)Next() * n) >> 32); }
+	//float value between min and max inclusive
+	float GetRandRange(float min, float max)
+	{
+		float alpha = Next() / (float)UINT32_MAX;
+		return min + (max - min) * alpha;
+	}
+	//integer variant
+	int GetRandRange(int min, int max)
+	{
+		float alpha = GetRandRange(0.f, 1.f);
+		return min + (int)roundf((max - min) * alpha);
+	}
+};
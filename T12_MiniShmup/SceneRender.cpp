@@ -0,0 +1,51 @@
+#include <assert.h>
+
+#include "SceneRender.h"
+#include "GameConstants.h"
+
+using namespace std;
+
+void Object::Init(RenderTex tex, const RenderRect& texRect, const Entities& ents, size_t idx)
+{
+	spr.tex = tex;
+	switch (ents.type[idx])
+	{
+	case ObjectT::Ship:
+		spr.texRect = texRect;
+		spr.scaleX = spr.scaleY = GC::SHIP_SCALE;
+		spr.rotation = 90;
+		break;
+	case ObjectT::Rock:
+	{
+		spr.texRect = RenderRect{ texRect.left, texRect.top, GC::ROCK_TEX_SIZE, GC::ROCK_TEX_SIZE };
+		float scale = ents.w[idx] / GC::ROCK_TEX_SIZE;
+		spr.scaleX = spr.scaleY = scale;
+		break;
+	}
+	case ObjectT::Bullet:
+		spr.texRect = RenderRect{ texRect.left, texRect.top, GC::BULLET_TEX_SIZE, GC::BULLET_TEX_SIZE };
+		spr.scaleX = spr.scaleY = GC::BULLET_SCALE;
+		break;
+	default:
+		assert(false);
+	}
+	spr.originX = spr.texRect.width / 2.f;
+	spr.originY = spr.texRect.height / 2.f;
+}
+
+void Object::Render(RenderBackend& r, const Entities& ents, size_t idx, float alpha)
+{
+	if (ents.Active(idx))
+	{
+		spr.x = ents.prevX[idx] + (ents.x[idx] - ents.prevX[idx]) * alpha;
+		spr.y = ents.prevY[idx] + (ents.y[idx] - ents.prevY[idx]) * alpha;
+		r.DrawSprite(spr);
+	}
+}
+
+void DrawCollisions(RenderBackend& r, const Entities& ents)
+{
+	for (size_t i = 0; i < ents.Size(); ++i)
+		if (ents.Active(i))
+			r.DrawCircle(ents.x[i], ents.y[i], ents.radius[i], ents.Colliding(i) ? RENDER_RED : RENDER_GREEN);
+}
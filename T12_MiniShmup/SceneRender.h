@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Entities.h"
+#include "RenderBackend.h"
+
+/*
+Drawing the simulation's entities, shared by the windowed game and the
+headless renderer so both measure the same submission code.
+*/
+
+/*
+A game object that could be a rock or the player
+Objects are anything with a sprite that can move around the screen
+and collide with other objets. This is only the rendering half, the
+simulation state (position, radius, health, etc) is in Entities at
+the same index and the sprite gets synced from it when drawing.
+Move only, build them in place with the constructor.
+*/
+struct Object
+{
+	RenderSprite spr;	//main image
+
+	Object() = default;
+	//same as Init
+	Object(RenderTex tex, const RenderRect& texRect, const Entities& ents, size_t idx) { Init(tex, texRect, ents, idx); }
+	Object(Object&&) = default;
+	Object& operator=(Object&&) = default;
+	Object(const Object&) = delete;
+	Object& operator=(const Object&) = delete;
+
+	/*
+	Call this to setup your object's sprite once the simulation has set up the entity
+	tex, texRect - image to use on the sprite
+	ents, idx - the simulation state for this object
+	*/
+	void Init(RenderTex tex, const RenderRect& texRect, const Entities& ents, size_t idx);
+	/*
+	copy position across from the simulation and submit it
+	alpha - 0 to 1, how far between the previous and current simulation position to draw it
+	*/
+	void Render(RenderBackend& r, const Entities& ents, size_t idx, float alpha);
+};
+
+/*
+Draw the collision radius of every active entity, red if it hit something
+*/
+void DrawCollisions(RenderBackend& r, const Entities& ents);
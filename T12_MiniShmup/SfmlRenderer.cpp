@@ -0,0 +1,112 @@
+#include <assert.h>
+
+#include "SfmlRenderer.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace sf;
+
+Color ToColor(RenderColor col)
+{
+	return Color(col.r, col.g, col.b, col.a);
+}
+
+SfmlRenderer::SfmlRenderer(RenderTarget& target_)
+	: target(&target_)
+{
+	circle.setPointCount(20);
+	circle.setOutlineThickness(2);
+	circle.setFillColor(Color::Transparent);
+}
+
+void SfmlRenderer::Begin()
+{
+	target->setView(target->getDefaultView());
+	target->clear();
+	batch.Clear();
+	batchTex = nullptr;
+	frameDraws = 0;
+}
+
+void SfmlRenderer::SetView(float width, float height)
+{
+	//what's batched so far was meant for the old view
+	Flush();
+	target->setView(View(FloatRect(0, 0, width, height)));
+}
+
+void SfmlRenderer::Use(RenderTex tex)
+{
+	if (tex != batchTex)
+	{
+		Flush();
+		batchTex = tex;
+	}
+}
+
+void SfmlRenderer::Flush()
+{
+	if (batch.NumQuads() == 0)
+		return;
+	PROFILE_SCOPE("SfmlRenderer::Flush");
+	frameDraws += batch.Draw(*target);
+	batch.Clear();
+}
+
+void SfmlRenderer::DrawSprite(const RenderSprite& spr)
+{
+	RenderVertex quad[4];
+	SpriteCorners(spr, quad);
+	DrawQuad(spr.tex, quad, spr.color);
+}
+
+void SfmlRenderer::DrawQuad(RenderTex tex, const RenderVertex quad[4], RenderColor col)
+{
+	Use(tex);
+	const Color c = ToColor(col);
+	Vertex verts[4];
+	for (int i = 0; i < 4; ++i)
+		verts[i] = Vertex(Vector2f(quad[i].x, quad[i].y), c, Vector2f(quad[i].u, quad[i].v));
+	batch.AddQuad((const Texture*)tex, verts);
+}
+
+void SfmlRenderer::DrawCircle(float x, float y, float radius, RenderColor col)
+{
+	//shapes don't batch, keep them in order with everything else
+	Flush();
+	circle.setRadius(radius);
+	circle.setOutlineColor(ToColor(col));
+	circle.setPosition(x, y);
+	circle.setOrigin(radius, radius);
+	target->draw(circle);
+	++frameDraws;
+}
+
+int SfmlRenderer::End()
+{
+	Flush();
+	batchTex = nullptr;
+	return frameDraws;
+}
+
+RenderRect ToRenderRect(const IntRect& rect)
+{
+	return RenderRect{ rect.left, rect.top, rect.width, rect.height };
+}
+
+RenderSprite ToRenderSprite(const Sprite& spr)
+{
+	RenderSprite r;
+	r.tex = spr.getTexture();
+	r.texRect = ToRenderRect(spr.getTextureRect());
+	r.originX = spr.getOrigin().x;
+	r.originY = spr.getOrigin().y;
+	r.scaleX = spr.getScale().x;
+	r.scaleY = spr.getScale().y;
+	r.rotation = spr.getRotation();
+	r.x = spr.getPosition().x;
+	r.y = spr.getPosition().y;
+	const Color& c = spr.getColor();
+	r.color = RenderColor{ c.r, c.g, c.b, c.a };
+	return r;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "SFML/Graphics.hpp"
+
+#include "RenderBackend.h"
+#include "SpriteBatch.h"
+
+/*
+Draws to an SFML window (or any render target). RenderTex is an
+sf::Texture*. Sprites and quads are batched until the texture changes,
+so painter's order is kept and runs of the same texture (or everything,
+with the atlas) go in one draw.
+*/
+struct SfmlRenderer : RenderBackend
+{
+	sf::RenderTarget* target = nullptr;
+	SpriteBatch batch;				//submissions since the texture last changed
+
+	explicit SfmlRenderer(sf::RenderTarget& target_);
+
+	void Begin() override;
+	void SetView(float width, float height) override;
+	void DrawSprite(const RenderSprite& spr) override;
+	void DrawQuad(RenderTex tex, const RenderVertex quad[4], RenderColor col) override;
+	void DrawCircle(float x, float y, float radius, RenderColor col) override;
+	int End() override;
+
+private:
+	//draw whatever has been batched
+	void Flush();
+	//flush first if tex isn't what's being batched
+	void Use(RenderTex tex);
+
+	RenderTex batchTex = nullptr;
+	int frameDraws = 0;
+	sf::CircleShape circle;		//reused by DrawCircle, building one each time allocates its points
+};
+
+//convert between SFML's types and the backend neutral ones
+RenderRect ToRenderRect(const sf::IntRect& rect);
+RenderSprite ToRenderSprite(const sf::Sprite& spr);
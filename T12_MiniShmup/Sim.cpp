@@ -0,0 +1,790 @@
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Sim.h"
+#include "CircleKernel.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+using namespace std;
+
+/*
+Smallest amount of work worth handing to another thread, below this
+the passes just run on the calling thread
+*/
+const size_t MOVE_TASK_MIN = 1024;		//entities moved
+const size_t BRUTE_TASK_MIN = 64;		//rows of the brute force pair loop
+const size_t GRID_TASK_MIN = 64;		//broadphase cells
+
+/*
+How much scratch to set aside per entity, from the high water marks of
+normal and stress runs with some headroom. Going over just allocates once.
+*/
+const size_t CANDIDATES_PER_ENTITY = 8;	//broadphase pairs
+const size_t TOUCHING_PER_ENTITY = 1;	//overlapping pairs, of each contact type
+const size_t SPAWN_NEARBY_MAX = 256;	//entities one spawn query looks at
+
+void TaskBuffers::Resize(int numTasks)
+{
+	if ((int)released.size() < numTasks)
+	{
+		released.resize(numTasks);
+		candidates.resize(numTasks);
+		touching.resize(numTasks * NUM_CONTACT_TYPES);
+		touchingTimed.resize(numTasks * NUM_CONTACT_TYPES);
+	}
+}
+
+void TaskBuffers::Reserve(int numTasks, size_t entities)
+{
+	if (numTasks <= reservedTasks && entities <= reservedEntities)
+		return;
+	Resize(numTasks);
+	for (int t = 0; t < numTasks; ++t)
+	{
+		const size_t share = t == 0 ? entities : entities / numTasks + 1;
+		released[t].reserve(share);
+		candidates[t].reserve(share * CANDIDATES_PER_ENTITY);
+		for (int c = 0; c < NUM_CONTACT_TYPES; ++c)
+		{
+			Touching(t, c).reserve(share * TOUCHING_PER_ENTITY);
+			TouchingTimed(t, c).reserve(share * TOUCHING_PER_ENTITY);
+		}
+	}
+	for (int c = 0; c < NUM_CONTACT_TYPES; ++c)
+	{
+		contacts[c].reserve(entities * TOUCHING_PER_ENTITY);
+		timedContacts[c].reserve(entities * TOUCHING_PER_ENTITY);
+	}
+	sweepX.reserve(entities);
+	sweepY.reserve(entities);
+	sweepR.reserve(entities);
+	reservedTasks = max(reservedTasks, numTasks);
+	reservedEntities = max(reservedEntities, entities);
+}
+
+void InitShip(Entities& ents, size_t idx, const Dim2Df& worldSz, const Dim2Df& shipSz)
+{
+	ents.w[idx] = shipSz.x;
+	ents.h[idx] = shipSz.y;
+	ents.x[idx] = shipSz.x * 0.6f;
+	ents.y[idx] = worldSz.y / 2.f;
+	ents.type[idx] = ObjectT::Ship;
+	ents.radius[idx] = 25.f;
+	ents.SetActive(idx, true);
+}
+
+void InitRock(Entities& ents, size_t idx, Rng& rng, float speed)
+{
+	float radius = GC::ROCK_RADIUS_MIN + (float)rng.Below(GC::ROCK_RADIUS_RANGE);
+	float scale = 0.75f * (radius / 25.f);
+	ents.w[idx] = ents.h[idx] = GC::ROCK_TEX_SIZE * scale;
+	ents.vx[idx] = -speed;
+	ents.radius[idx] = radius;
+	ents.health[idx] = (int)(5 * scale);
+	ents.SetActive(idx, false);
+	ents.type[idx] = ObjectT::Rock;
+}
+
+void InitBullet(Entities& ents, size_t idx)
+{
+	ents.w[idx] = ents.h[idx] = GC::BULLET_TEX_SIZE * GC::BULLET_SCALE;
+	ents.vx[idx] = GC::BULLET_SPEED;
+	ents.radius[idx] = 5.f;
+	ents.SetActive(idx, false);
+	ents.type[idx] = ObjectT::Bullet;
+}
+
+void UpdateEntities(Entities& ents, const Dim2Df& worldSz, float elapsed, const Input& input,
+	ThreadPool* threads, TaskBuffers& tasks)
+{
+	PROFILE_SCOPE("UpdateEntities");
+	const size_t num = ents.Size();
+	//ships first on their own, firing takes bullets from the pool
+	size_t first = 0;
+	for (; first < num && ents.type[first] == ObjectT::Ship; ++first)
+	{
+		if (ents.Active(first))
+			PlayerControl(ents, first, worldSz, elapsed, input);
+	}
+
+	//the rest only touch their own entity, anything leaving the screen is
+	//released afterwards in index order so the pools end up the same
+	for (size_t t = 0; t < tasks.released.size(); ++t)
+		tasks.released[t].clear();
+	ParallelFor(threads, num - first, MOVE_TASK_MIN, [&](size_t begin, size_t end, int task) {
+		vector<size_t>& released = tasks.released[task];
+		for (size_t i = first + begin; i < first + end; ++i)
+		{
+			if (ents.Active(i))
+			{
+				bool gone = false;
+				switch (ents.type[i])
+				{
+				case ObjectT::Rock:
+					gone = MoveRock(ents, i, elapsed);
+					break;
+				case ObjectT::Bullet:
+					gone = MoveBullet(ents, i, worldSz, elapsed);
+					break;
+				default:
+					assert(false);	//ships must come before everything else
+				}
+				if (gone)
+					released.push_back(i);
+			}
+		}
+	});
+	for (size_t t = 0; t < tasks.released.size(); ++t)
+		for (size_t i = 0; i < tasks.released[t].size(); ++i)
+			ents.Release(tasks.released[t][i]);
+}
+
+bool MoveRock(Entities& ents, size_t idx, float elapsed)
+{
+	ents.x[idx] += ents.vx[idx] * elapsed;
+	return ents.x[idx] < -ents.w[idx] / 2.f;
+}
+
+bool MoveBullet(Entities& ents, size_t idx, const Dim2Df& worldSz, float elapsed)
+{
+	ents.x[idx] += ents.vx[idx] * elapsed;
+	return ents.x[idx] > (worldSz.x + ents.w[idx] / 2.f);
+}
+
+Dim2Df Decay(Dim2Df& currentVal, float rate, float perSec, float dTimeS)
+{
+	float mod = 1.0f - rate * (dTimeS / perSec);
+	Dim2Df alpha{ currentVal.x * mod, currentVal.y * mod };
+	return alpha;
+}
+
+void PlayerControl(Entities& ents, size_t idx, const Dim2Df& worldSz, float elapsed, const Input& input)
+{
+	Dim2Df pos{ ents.x[idx], ents.y[idx] };
+	const float SPEED = 250.f;
+	const float width = ents.w[idx], height = ents.h[idx];
+
+	//the ship's velocity is its thrust, it decays away when nothing is pressed
+	Dim2Df thrust{ ents.vx[idx], ents.vy[idx] };
+
+	if (input.up || input.down || input.left || input.right)
+	{
+		if (input.up)
+			thrust.y = -SPEED;
+		else if (input.down)
+			thrust.y = SPEED;
+		if (input.left)
+			thrust.x = -SPEED;
+		else if (input.right)
+			thrust.x = SPEED;
+	}
+
+	pos.x += thrust.x * elapsed;
+	pos.y += thrust.y * elapsed;
+	thrust = Decay(thrust, 0.1f, 0.02f, elapsed);
+	ents.vx[idx] = thrust.x;
+	ents.vy[idx] = thrust.y;
+
+	if (pos.y < (height * 0.6f))
+		pos.y = height * 0.6f;
+	if (pos.y > (worldSz.y - height * 0.6f))
+		pos.y = worldSz.y - height * 0.6f;
+	if (pos.x < (width * 0.6f))
+		pos.x = width * 0.6f;
+	if (pos.x > (worldSz.x - width * 0.6f))
+		pos.x = worldSz.x - width * 0.6f;
+
+	ents.x[idx] = pos.x;
+	ents.y[idx] = pos.y;
+
+	if (input.fire)
+		FireBullet(ents, pos.x + width / 2.f, pos.y);
+}
+
+void FireBullet(Entities& ents, float x, float y)
+{
+	size_t idx = ents.Acquire(ObjectT::Bullet);
+	if (idx != SIZE_MAX)
+	{
+		ents.x[idx] = x;
+		ents.y[idx] = y;
+		ents.SnapPrev(idx);
+	}
+}
+
+void TakeDamage(Entities& ents, size_t idx, int amount)
+{
+	ents.health[idx] -= amount;
+	if (ents.health[idx] <= 0)
+		ents.Release(idx);
+}
+
+bool CircleToCircle(float x1, float y1, float x2, float y2, float minDist)
+{
+	float dist = (x1 - x2) * (x1 - x2) +
+		(y1 - y2) * (y1 - y2);
+	return dist <= minDist * minDist;
+}
+
+bool SweptCircleToCircle(float ax0, float ay0, float ax1, float ay1,
+	float bx0, float by0, float bx1, float by1, float minDist, float& toi)
+{
+	//work relative to b, so a moves from d to d + v and we want the first t in
+	//0 to 1 with |d + v * t| <= minDist
+	const float dx = ax0 - bx0, dy = ay0 - by0;
+	const float vx = (ax1 - ax0) - (bx1 - bx0), vy = (ay1 - ay0) - (by1 - by0);
+	const float c = dx * dx + dy * dy - minDist * minDist;
+	if (c <= 0)
+	{
+		toi = 0;
+		return true;
+	}
+	const float a = vx * vx + vy * vy;
+	const float b = dx * vx + dy * vy;
+	if (a == 0 || b >= 0)
+		return false;	//not moving relative to each other, or moving apart
+	const float disc = b * b - a * c;
+	if (disc < 0)
+		return false;	//closest approach misses
+	const float t = (-b - sqrtf(disc)) / a;
+	if (t > 1.f)
+	{
+		//rounding can push a touch right at the end just past it
+		if (!CircleToCircle(ax1, ay1, bx1, by1, minDist))
+			return false;
+		toi = 1.f;
+		return true;
+	}
+	toi = t;
+	return true;
+}
+
+/*
+Exact swept test for a pair of entities over their last move
+*/
+bool SweptTouching(const Entities& ents, size_t a, size_t b, float& toi)
+{
+	return SweptCircleToCircle(ents.prevX[a], ents.prevY[a], ents.x[a], ents.y[a],
+		ents.prevX[b], ents.prevY[b], ents.x[b], ents.y[b], ents.radius[a] + ents.radius[b], toi);
+}
+
+/*
+The circles the broadphase and kernel test - where each entity ended up or,
+for swept collisions, a circle around its whole move so any pair that could
+touch during the update overlaps and goes on to the exact test
+*/
+struct CollisionShapes
+{
+	const float* x;
+	const float* y;
+	const float* r;
+};
+
+CollisionShapes GetCollisionShapes(const Entities& ents, ThreadPool* threads, TaskBuffers& tasks, bool swept)
+{
+	if (!swept)
+		return CollisionShapes{ ents.x.data(), ents.y.data(), ents.radius.data() };
+	const size_t num = ents.Size();
+	tasks.sweepX.resize(num);
+	tasks.sweepY.resize(num);
+	tasks.sweepR.resize(num);
+	ParallelFor(threads, num, MOVE_TASK_MIN, [&](size_t begin, size_t end, int) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			const float dx = ents.x[i] - ents.prevX[i], dy = ents.y[i] - ents.prevY[i];
+			tasks.sweepX[i] = (ents.x[i] + ents.prevX[i]) * 0.5f;
+			tasks.sweepY[i] = (ents.y[i] + ents.prevY[i]) * 0.5f;
+			tasks.sweepR[i] = ents.radius[i] + 0.5f * sqrtf(dx * dx + dy * dy);
+		}
+	});
+	return CollisionShapes{ tasks.sweepX.data(), tasks.sweepY.data(), tasks.sweepR.data() };
+}
+
+/*
+Keep a pair the kernel found overlapping in a task's buffer for its contact
+type. For swept collisions only if the exact test says they met, along
+with when, so responding doesn't have to solve it again.
+*/
+void AddTouching(const Entities& ents, bool swept, int a, int b, int contact, TaskBuffers& tasks, int task)
+{
+	const uint64_t pair = SpatialGrid::MakePair(a, b);
+	if (!swept)
+	{
+		tasks.Touching(task, contact).push_back(pair);
+		return;
+	}
+	float toi;
+	if (SweptTouching(ents, SpatialGrid::PairLow(pair), SpatialGrid::PairHigh(pair), toi))
+		tasks.TouchingTimed(task, contact).push_back(TimedHit{ toi, pair });
+}
+
+//empty every task's touching buffers before a pass
+void ClearTouching(TaskBuffers& tasks)
+{
+	for (size_t t = 0; t < tasks.touching.size(); ++t)
+	{
+		tasks.touching[t].clear();
+		tasks.touchingTimed[t].clear();
+	}
+}
+
+/*
+Gather every task's touching pairs into tasks.contacts, or their swept hits
+into tasks.timedContacts, in task order
+*/
+void MergeTouching(TaskBuffers& tasks, bool swept)
+{
+	const int numTasks = (int)tasks.touching.size() / NUM_CONTACT_TYPES;
+	for (int c = 0; c < NUM_CONTACT_TYPES; ++c)
+	{
+		vector<uint64_t>& contacts = tasks.contacts[c];
+		vector<TimedHit>& timed = tasks.timedContacts[c];
+		contacts.clear();
+		timed.clear();
+		for (int t = 0; t < numTasks; ++t)
+		{
+			if (swept)
+				timed.insert(timed.end(), tasks.TouchingTimed(t, c).begin(), tasks.TouchingTimed(t, c).end());
+			else
+				contacts.insert(contacts.end(), tasks.Touching(t, c).begin(), tasks.Touching(t, c).end());
+		}
+	}
+}
+
+/*
+Respond to tasks.contacts a contact type at a time as sorted pairs, or for
+swept collisions tasks.timedContacts in time of impact order. Colliding flags are cleared here
+rather than when moving, so the last update's hits are still set when the
+frame is drawn (see DrawCollisions).
+*/
+void RespondToTouching(Entities& ents, TaskBuffers& tasks, bool swept)
+{
+	for (size_t i = 0; i < ents.Size(); ++i)
+		ents.SetColliding(i, false);
+	for (int c = 0; c < NUM_CONTACT_TYPES; ++c)
+	{
+		if (swept)
+			RespondToTimedContacts(ents, c, tasks.timedContacts[c]);
+		else
+			RespondToContacts(ents, c, tasks.contacts[c]);
+	}
+}
+
+void CheckCollisions(Entities& ents, ThreadPool* threads, TaskBuffers& tasks, bool swept)
+{
+	PROFILE_SCOPE("CheckCollisions");
+	const CollisionShapes shapes = GetCollisionShapes(ents, threads, tasks, swept);
+	//find every touching pair first, positions and flags don't change while we look
+	//so rows can be split over threads. Tasks take rows in order and each row's hits
+	//come out in order so the merged list is already sorted.
+	const size_t num = ents.Size();
+	ClearTouching(tasks);
+	ParallelFor(threads, num, BRUTE_TASK_MIN, [&](size_t begin, size_t end, int task) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (!ents.Active(i))
+				continue;
+			//test the rest of the row a block at a time
+			for (size_t first = i + 1; first < num; first += CIRCLE_BLOCK_MAX)
+			{
+				const int count = (int)min((size_t)CIRCLE_BLOCK_MAX, num - first);
+				uint32_t mask = CircleOverlapMask(shapes.x[i], shapes.y[i], shapes.r[i],
+					&shapes.x[first], &shapes.y[first], &shapes.r[first], count);
+				while (mask)
+				{
+					const size_t ii = first + LowestSetBit(mask);
+					mask &= mask - 1;
+					const int contact = GetContactType(ents.type[i], ents.type[ii]);
+					if (contact != NO_CONTACT && ents.Active(ii))
+						AddTouching(ents, swept, (int)i, (int)ii, contact, tasks, task);
+				}
+			}
+		}
+	});
+	MergeTouching(tasks, swept);
+	RespondToTouching(ents, tasks, swept);
+}
+
+/*
+Overlap test broadphase candidates, each run sharing a first entity is packed
+into blocks for the kernel, leaving out pairs of types that don't affect each other
+shapes, swept - circles to give the kernel, and whether its hits need the exact swept test
+cands - pairs grouped by first id as SpatialGrid::FindPairs hands them out
+tasks, task - pairs that overlap get added to this task's buffers, smaller id first
+*/
+void TestCandidates(const Entities& ents, const CollisionShapes& shapes, bool swept,
+	const vector<uint64_t>& cands, TaskBuffers& tasks, int task)
+{
+	float bx[CIRCLE_BLOCK_MAX], by[CIRCLE_BLOCK_MAX], br[CIRCLE_BLOCK_MAX];
+	int bIdx[CIRCLE_BLOCK_MAX], bContact[CIRCLE_BLOCK_MAX];
+	const size_t numCands = cands.size();
+	size_t p = 0;
+	while (p < numCands)
+	{
+		const int a = SpatialGrid::PairLow(cands[p]);
+		const ObjectT aType = ents.type[a];
+		int count = 0;
+		for (; count < CIRCLE_BLOCK_MAX && p < numCands && SpatialGrid::PairLow(cands[p]) == a; ++p)
+		{
+			//most candidates are rocks next to rocks, which don't do anything to each other
+			const int b = SpatialGrid::PairHigh(cands[p]);
+			const int contact = GetContactType(aType, ents.type[b]);
+			if (contact == NO_CONTACT)
+				continue;
+			bIdx[count] = b;
+			bContact[count] = contact;
+			bx[count] = shapes.x[b];
+			by[count] = shapes.y[b];
+			br[count] = shapes.r[b];
+			++count;
+		}
+		if (count == 0)
+			continue;
+		uint32_t mask = CircleOverlapMask(shapes.x[a], shapes.y[a], shapes.r[a], bx, by, br, count);
+		while (mask)
+		{
+			const int k = LowestSetBit(mask);
+			mask &= mask - 1;
+			AddTouching(ents, swept, a, bIdx[k], bContact[k], tasks, task);
+		}
+	}
+}
+
+void CheckCollisionsGrid(Entities& ents, SpatialGrid& grid, ThreadPool* threads, TaskBuffers& tasks, bool swept)
+{
+	PROFILE_SCOPE("CheckCollisionsGrid");
+	const CollisionShapes shapes = GetCollisionShapes(ents, threads, tasks, swept);
+	grid.Clear();
+	for (size_t i = 0; i < ents.Size(); ++i)
+		if (ents.Active(i))
+			grid.Add(shapes.x[i], shapes.y[i], shapes.r[i], (int)i);
+	grid.Build();
+
+	//each task finds and tests the candidates for a range of cells, then the
+	//touching pairs are sorted into the order the brute force loops find them
+	//so hits get the same responses
+	ClearTouching(tasks);
+	ParallelFor(threads, (size_t)grid.NumCells(), GRID_TASK_MIN, [&](size_t begin, size_t end, int task) {
+		vector<uint64_t>& cands = tasks.candidates[task];
+		cands.clear();
+		grid.FindPairs((int)begin, (int)end, cands);
+		TestCandidates(ents, shapes, swept, cands, tasks, task);
+	});
+	MergeTouching(tasks, swept);
+	//swept hits are put in time of impact order when they're responded to
+	if (!swept)
+		for (int c = 0; c < NUM_CONTACT_TYPES; ++c)
+			sort(tasks.contacts[c].begin(), tasks.contacts[c].end());
+	RespondToTouching(ents, tasks, swept);
+}
+
+bool IsColliding(const Entities& ents, float x, float y, float radius, size_t skip)
+{
+	const size_t num = ents.Size();
+	for (size_t first = 0; first < num; first += CIRCLE_BLOCK_MAX)
+	{
+		const int count = (int)min((size_t)CIRCLE_BLOCK_MAX, num - first);
+		uint32_t mask = CircleOverlapMask(x, y, radius, &ents.x[first], &ents.y[first], &ents.radius[first], count);
+		while (mask)
+		{
+			const size_t idx = first + LowestSetBit(mask);
+			mask &= mask - 1;
+			if (idx != skip && ents.Active(idx))
+				return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+A random spot in the ring minDist to 2 * minDist around x,y, by rejection
+so it's the same on every platform (no sin/cos)
+*/
+void PointInRing(Rng& rng, float x, float y, float minDist, float& outX, float& outY)
+{
+	float dx, dy, d2;
+	do {
+		dx = rng.GetRandRange(-2.f, 2.f);
+		dy = rng.GetRandRange(-2.f, 2.f);
+		d2 = dx * dx + dy * dy;
+	} while (d2 < 1.f || d2 > 4.f);
+	outX = x + dx * minDist;
+	outY = y + dy * minDist;
+}
+
+void PlaceRocks(const Dim2Df& worldSz, Entities& ents, Rng& rng, int count)
+{
+	//everything already active is in the way, the grid only ever looks at nearby cells
+	const float maxRock = GC::ROCK_RADIUS_MIN + GC::ROCK_RADIUS_RANGE - 1;
+	PlacementGrid grid;
+	grid.Reset(0, 0, worldSz.x, worldSz.y, maxRock * (GC::ROCK_MIN_DIST + 1.f), 2 * (ents.Size() + count) + 64);
+	for (size_t i = 0; i < ents.Size(); ++i)
+		if (ents.Active(i))
+			grid.Insert(ents.x[i], ents.y[i], ents.radius[i]);
+
+	//Bridson's Poisson-disk sampling: each new rock tries GC::PLACE_TRIES spots in a
+	//ring around a random rock already placed, and a rock that can't fit anything is
+	//dropped from the active list. Only when they're all boxed in does a rock try
+	//random spots over the whole world, and we stop once that fails too.
+	vector<size_t> active;
+	for (int placed = 0; placed < count; ++placed)
+	{
+		size_t idx = ents.Add(ObjectT::Rock);
+		InitRock(ents, idx, rng);
+		const float clearance = ents.radius[idx] * GC::ROCK_MIN_DIST;
+		float x = 0, y = 0;
+		bool found = false;
+		while (!found && !active.empty())
+		{
+			const size_t a = rng.Below((uint32_t)active.size());
+			const size_t from = active[a];
+			for (int tries = 0; tries < GC::PLACE_TRIES && !found; ++tries)
+			{
+				PointInRing(rng, ents.x[from], ents.y[from], clearance + ents.radius[from], x, y);
+				found = x >= 0 && x < worldSz.x && y >= 0 && y < worldSz.y && !grid.Overlaps(x, y, clearance);
+			}
+			if (!found)
+			{
+				active[a] = active.back();
+				active.pop_back();
+			}
+		}
+		for (int tries = 0; tries < GC::PLACE_TRIES && !found; ++tries)
+		{
+			x = rng.GetRandRange(0.f, worldSz.x);
+			y = rng.GetRandRange(0.f, worldSz.y);
+			found = !grid.Overlaps(x, y, clearance);
+		}
+		if (!found)
+		{
+			ents.Resize(idx);
+			break;
+		}
+		ents.x[idx] = x;
+		ents.y[idx] = y;
+		ents.SetActive(idx, true);
+		ents.SnapPrev(idx);
+		grid.Insert(x, y, ents.radius[idx]);
+		active.push_back(idx);
+	}
+	ents.RebuildPools();
+}
+
+bool SpawnRock(const Dim2Df& worldSz, Entities& ents, Rng& rng, float extraClearance, SpawnQuery* query)
+{
+	size_t idx = ents.Acquire(ObjectT::Rock);
+	if (idx == SIZE_MAX)
+		return false;
+
+	float y = (ents.h[idx] / 2.f) + rng.Below((uint32_t)(worldSz.y - ents.h[idx]));
+	ents.x[idx] = worldSz.x + ents.w[idx];
+	ents.y[idx] = y;
+	const float radius = ents.radius[idx] + extraClearance;
+	if (query ? query->IsColliding(ents, ents.x[idx], ents.y[idx], radius, idx) : IsColliding(ents, ents.x[idx], ents.y[idx], radius, idx))
+	{
+		//hand it straight back, it'll be the next one tried
+		ents.Release(idx);
+		return false;
+	}
+	ents.SnapPrev(idx);
+	if (query)
+		query->Placed(idx);
+	return true;
+}
+
+void SimConfig::Validate()
+{
+	stressRocks = min(max(stressRocks, 0), GC::STRESS_ROCKS_MAX);
+	rocks = min(max(max(rocks, 0), stressRocks), GC::ROCKS_MAX);
+	bullets = min(max(bullets, 0), GC::BULLETS_MAX);
+	maxRocks = min(max(maxRocks, rocks), GC::ROCKS_MAX);
+	maxBullets = min(max(maxBullets, bullets), GC::BULLETS_MAX);
+	swept = swept ? 1 : 0;
+	spawnDelay = max(spawnDelay, 0.001f);
+	rockClearance = max(rockClearance, 0.f);
+	rockSpeed = max(rockSpeed, 0.f);
+}
+
+size_t GrowPool(Entities& ents, ObjectT type, size_t count, Rng& rng, float rockSpeed)
+{
+	const size_t first = ents.Size();
+	ents.Resize(first + count);
+	for (size_t i = first; i < first + count; ++i)
+	{
+		switch (type)
+		{
+		case ObjectT::Rock:
+			InitRock(ents, i, rng, rockSpeed);
+			break;
+		case ObjectT::Bullet:
+			InitBullet(ents, i);
+			break;
+		default:
+			assert(false);	//there's only ever one ship
+		}
+	}
+	ents.RebuildPools();
+	return first;
+}
+
+Dim2Df StressWorldSize(const Dim2Df& screenSz, int rocks)
+{
+	const float scale = sqrtf(rocks * GC::STRESS_AREA_PER_ROCK / (screenSz.x * screenSz.y));
+	if (scale <= 1.f)
+		return screenSz;
+	return Dim2Df{ screenSz.x * scale, screenSz.y * scale };
+}
+
+void ScatterRocks(const Dim2Df& worldSz, Entities& ents, size_t first, size_t end, Rng& rng,
+	size_t keepAway, float clearance)
+{
+	for (size_t i = first; i < end; ++i)
+	{
+		if (ents.type[i] != ObjectT::Rock || ents.Active(i))
+			continue;
+		const float minDist = ents.radius[i] + ents.radius[keepAway] + clearance;
+		do {
+			ents.x[i] = rng.GetRandRange(0.f, worldSz.x);
+			ents.y[i] = rng.GetRandRange(0.f, worldSz.y);
+		} while (CircleToCircle(ents.x[i], ents.y[i], ents.x[keepAway], ents.y[keepAway], minDist));
+		ents.SetActive(i, true);
+		ents.SnapPrev(i);
+	}
+	ents.RebuildPools();
+}
+
+void Sim::Init(const Dim2Df& worldSz_, const Dim2Df& shipSz, uint32_t seed, const SimConfig& cfg_)
+{
+	worldSz = worldSz_;
+	frame = 0;
+	rng.Seed(seed);
+	cfg = cfg_;
+	cfg.Validate();
+
+	//ship first, then the rocks, then bullets
+	const size_t numObjects = 1 + cfg.rocks + cfg.bullets;
+	ents.Clear();
+	ents.Reserve(MaxEntities());
+	ents.Resize(numObjects);
+	InitShip(ents, 0, worldSz, shipSz);
+	ents.SnapPrev(0);
+	for (size_t i = 1; i <= (size_t)cfg.rocks; ++i)
+		InitRock(ents, i, rng, cfg.rockSpeed);
+	for (size_t i = cfg.rocks + 1; i < numObjects; ++i)
+		InitBullet(ents, i);
+	ents.RebuildPools();
+
+	spawnTimer = 0;
+	spawnDelay = cfg.spawnDelay;
+	rockShipClearance = ents.w[0] * cfg.rockClearance;
+	if (cfg.stressRocks)
+		ScatterRocks(worldSz, ents, 1, 1 + cfg.stressRocks, rng, 0, rockShipClearance);
+
+	//everything else an update uses is sized now for as big as the pools can get
+	grid.Reserve(MaxEntities());
+	spawnQuery.Reserve(SPAWN_NEARBY_MAX);
+	tasks.Reserve(MaxTasks(threads), MaxEntities());
+}
+
+void Sim::GrowPools()
+{
+	//double, so a run that keeps needing more only grows a handful of times
+	const ObjectT types[] = { ObjectT::Rock, ObjectT::Bullet };
+	const int maxes[] = { cfg.maxRocks, cfg.maxBullets };
+	for (int t = 0; t < 2; ++t)
+	{
+		const EntityPool& pool = ents.pools[(int)types[t]];
+		if (pool.free.empty() && pool.total < (size_t)maxes[t])
+			GrowPool(ents, types[t], min(max(pool.total, (size_t)1), maxes[t] - pool.total), rng, cfg.rockSpeed);
+	}
+}
+
+int FixedStep::Advance(float elapsed)
+{
+	assert(dt > 0);
+	accumulator += elapsed;
+	int steps = (int)(accumulator / dt);
+	if (steps > maxSteps)
+	{
+		steps = maxSteps;
+		accumulator = 0;
+	}
+	else
+		accumulator -= steps * dt;
+	return steps;
+}
+
+void Sim::Update(float elapsed, const Input& input)
+{
+	PROFILE_SCOPE("Sim::Update");
+	GrowPools();
+
+	tasks.Reserve(MaxTasks(threads), MaxEntities());
+	//collide over the last move before starting the next one
+	if (bruteCollisions)
+		CheckCollisions(ents, threads, tasks, cfg.swept != 0);
+	else
+		CheckCollisionsGrid(ents, grid, threads, tasks, cfg.swept != 0);
+
+	//a long frame can owe several rocks, spawn one per spawnDelay that has passed.
+	//The collision grid is still current so room is checked in nearby cells only,
+	//brute force keeps testing everything as the reference.
+	assert(spawnDelay > 0);
+	spawnTimer += elapsed;
+	spawnQuery.Reset(bruteCollisions ? nullptr : &grid);
+	{
+		PROFILE_SCOPE("SpawnRock");
+		while (spawnTimer >= spawnDelay)
+		{
+			if (SpawnRock(worldSz, ents, rng, rockShipClearance, &spawnQuery))
+				spawnTimer -= spawnDelay;
+			else
+			{
+				//no room, try again next frame but don't bank up a burst while blocked
+				spawnTimer = spawnDelay;
+				break;
+			}
+		}
+	}
+
+	ents.prevX = ents.x;
+	ents.prevY = ents.y;
+	UpdateEntities(ents, worldSz, elapsed, input, threads, tasks);
+	++frame;
+}
+
+/*
+FNV-1a over raw bytes
+*/
+uint64_t HashBytes(uint64_t h, const void* data, size_t bytes)
+{
+	const uint8_t* p = (const uint8_t*)data;
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		h ^= p[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+uint64_t HashState(const Entities& ents)
+{
+	const size_t num = ents.Size();
+	uint64_t h = 14695981039346656037ull;
+	if (num == 0)
+		return h;
+	h = HashBytes(h, ents.x.data(), num * sizeof(float));
+	h = HashBytes(h, ents.y.data(), num * sizeof(float));
+	h = HashBytes(h, ents.vx.data(), num * sizeof(float));
+	h = HashBytes(h, ents.vy.data(), num * sizeof(float));
+	h = HashBytes(h, ents.flags.data(), num * sizeof(uint8_t));
+	h = HashBytes(h, ents.health.data(), num * sizeof(int));
+	//which entity comes out of each pool next matters too
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+		if (!ents.pools[t].free.empty())
+			h = HashBytes(h, ents.pools[t].free.data(), ents.pools[t].free.size() * sizeof(size_t));
+	return h;
+}
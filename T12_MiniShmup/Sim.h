@@ -0,0 +1,261 @@
+#pragma once
+
+#include "GameConstants.h"
+#include "Entities.h"
+#include "SpatialGrid.h"
+#include "Rng.h"
+#include "Contacts.h"
+#include "Placement.h"
+
+struct ThreadPool;
+
+/*
+The game simulation with no window, textures or keyboard.
+Everything it needs from the outside world comes in as plain values
+(world size, ship size, an Input snapshot per update) so it can run
+headless for profiling and batch runs, or under the windowed Game.
+*/
+
+/*
+What the player is asking for on one update, read from the keyboard
+by the windowed game or scripted when headless
+*/
+struct Input
+{
+	bool up = false;
+	bool down = false;
+	bool left = false;
+	bool right = false;
+	bool fire = false;	//launch a bullet this update
+};
+
+/*
+Turns variable frame times into a whole number of fixed size simulation
+updates, so behaviour and cost don't depend on the frame rate. Leftover
+time carries over to the next frame and Alpha says how far we are between
+the last update and the next one, for interpolating when drawing.
+*/
+struct FixedStep
+{
+	float dt = 1.f / GC::TICK_RATE;		//length of one update
+	float accumulator = 0;				//time owed to the simulation
+	int maxSteps = GC::MAX_TICKS_PER_FRAME;	//most updates one frame can ask for
+
+	void SetRate(float ticksPerSec) { dt = 1.f / ticksPerSec; }
+	//add a frame's elapsed time, returns how many updates to run now
+	int Advance(float elapsed);
+	//0 to 1, fraction of an update left over
+	float Alpha() const { return accumulator / dt; }
+};
+
+/*
+Per task output of the multi-threaded passes, kept between updates so
+they don't reallocate. Each task only writes its own slot and they're
+merged in task order (or sorted) afterwards, so the result is the same
+whether one thread did the work or many.
+*/
+struct TaskBuffers
+{
+	std::vector<std::vector<size_t>> released;		//entities that moved off screen
+	std::vector<std::vector<uint64_t>> candidates;	//broadphase pairs
+	std::vector<std::vector<uint64_t>> touching;	//pairs that overlap, packed low<<32|high, per task and contact type
+	std::vector<std::vector<TimedHit>> touchingTimed;	//same for swept collisions, with when they touched
+	std::vector<uint64_t> contacts[NUM_CONTACT_TYPES];	//every task's touching pairs by contact type, sorted for responding to
+	std::vector<float> sweepX, sweepY, sweepR;		//circle around each entity's last move, for swept collisions
+	std::vector<TimedHit> timedContacts[NUM_CONTACT_TYPES];	//every task's swept hits by contact type, sorted by when they happened for responding to
+	int reservedTasks = 0;		//what Reserve last sized for
+	size_t reservedEntities = 0;
+
+	//make sure there's a slot for every task
+	void Resize(int numTasks);
+	/*
+	Resize, then size every buffer up front for the most entities an update
+	can have so updates don't allocate, does nothing if it already has. Tasks
+	are sized for an even share (task 0 for all of them, as small jobs run on
+	it alone), a task that's handed more grows once and keeps it.
+	*/
+	void Reserve(int numTasks, size_t entities);
+	//where a task puts touching pairs of one contact type
+	std::vector<uint64_t>& Touching(int task, int type) { return touching[task * NUM_CONTACT_TYPES + type]; }
+	std::vector<TimedHit>& TouchingTimed(int task, int type) { return touchingTimed[task * NUM_CONTACT_TYPES + type]; }
+};
+
+/*
+How big the entity pools are and how hard the game is, set at runtime
+(see Config.h) rather than fixed by GC. The pools start at rocks/bullets and when one runs dry at the start of
+an update it doubles, up to the max. New entities go on the end of Entities
+so indices already handed out stay valid. Leaving max at the starting size
+keeps the pools fixed.
+*/
+struct SimConfig
+{
+	int rocks = GC::NUM_ROCKS;			//rock pool to start with
+	int bullets = GC::NUM_BULLETS;		//bullet pool to start with
+	int maxRocks = GC::NUM_ROCKS;		//most the rock pool can grow to
+	int maxBullets = GC::NUM_BULLETS;	//most the bullet pool can grow to
+	int stressRocks = 0;				//stress mode, start with this many active rocks scattered over the world, 0 is off
+	int swept = 1;						//1 tests the whole of each move for collisions so nothing tunnels at long timesteps, 0 only where things ended up
+	//balancing, how hard the game is
+	float spawnDelay = 0.01f;			//seconds between new rocks coming in, smaller is harder
+	float rockClearance = 2.f;			//ship widths a new rock keeps from everything else, smaller is harder
+	float rockSpeed = GC::ROCK_SPEED;	//how fast rocks fly left
+
+	//keep everything in range - maxes at least the starting sizes, pools at most GC::ROCKS_MAX/BULLETS_MAX, at most GC::STRESS_ROCKS_MAX stress rocks
+	void Validate();
+};
+
+/*
+Manage the asteroid dodging simulation
+*/
+struct Sim
+{
+	Dim2Df worldSz{ 0, 0 };			//play area, things leaving it deactivate
+	uint32_t frame = 0;				//updates since Init
+	Entities ents;					//anything moving around - ship first, then rocks, then bullets
+	float spawnTimer = 0.f;			//a clock
+	float spawnDelay = 0.f;			//how long to wait before another asteroid comes in, from cfg.spawnDelay
+	float rockShipClearance = 2.f;	//how far a new asteroid keeps from everything else, cfg.rockClearance ship widths
+	SpatialGrid grid;				//collision broadphase, rebuilt every update
+	SpawnQuery spawnQuery;			//finds room for new rocks from grid
+	bool bruteCollisions = false;	//test every pair instead of using the grid, kept as a reference to compare against
+	ThreadPool* threads = nullptr;	//not owned, spread the movement and collision tests over it, null for single threaded
+	TaskBuffers tasks;				//scratch for the threaded passes
+	Rng rng;						//every random choice the simulation makes, seeded by Init
+	SimConfig cfg;					//pool sizes and balancing, set by Init
+
+	/*
+	create ship, rocks and bullets, set all rocks initially inactive
+	worldSz_ - width and height of the play area
+	shipSz - width and height of the ship on screen
+	seed - the same seed and inputs always play out the same way
+	cfg_ - pool sizes, stress mode and balancing, for stress mode worldSz_ should come from StressWorldSize
+	*/
+	void Init(const Dim2Df& worldSz_, const Dim2Df& shipSz, uint32_t seed, const SimConfig& cfg_ = SimConfig());
+	/*
+	collide everything over the last move (prevX/prevY to x/y), spawn new rocks
+	then move the ship and rocks, positions before the move are kept in prevX/prevY.
+	Everything it needs is sized by Init (and again if threads changes) so it
+	doesn't allocate, besides a pool growing.
+	*/
+	void Update(float elapsed, const Input& input);
+	//grow any empty pool that's allowed to, called at the start of Update
+	void GrowPools();
+	//most entities the pools can grow to, what the per update buffers are sized for
+	size_t MaxEntities() const { return 1 + (size_t)cfg.maxRocks + cfg.maxBullets; }
+};
+
+/*
+Add count inactive entities of one type to the end of ents and its pool.
+Nothing already there moves, so indices held elsewhere (Objects, hit pairs,
+other pools) stay valid. Returns the first new index.
+*/
+size_t GrowPool(Entities& ents, ObjectT type, size_t count, Rng& rng, float rockSpeed = GC::ROCK_SPEED);
+
+/*
+World big enough to hold rocks at GC::STRESS_AREA_PER_ROCK each, with the
+same shape as the screen and never smaller than it
+*/
+Dim2Df StressWorldSize(const Dim2Df& screenSz, int rocks);
+
+/*
+Activate every inactive rock in [first, end) at a random spot, overlaps
+allowed so it's O(n) however many there are. Stays clear of entity keepAway
+by clearance so the ship isn't hit on the first update.
+*/
+void ScatterRocks(const Dim2Df& worldSz, Entities& ents, size_t first, size_t end, Rng& rng,
+	size_t keepAway, float clearance);
+
+//called by Sim::Init to set up each type
+void InitShip(Entities& ents, size_t idx, const Dim2Df& worldSz, const Dim2Df& shipSz);
+void InitRock(Entities& ents, size_t idx, Rng& rng, float speed = GC::ROCK_SPEED);
+void InitBullet(Entities& ents, size_t idx);
+
+/*
+Move and update logic for every active entity
+ents - everything, the ships at the start go first on their own as firing takes
+	from the bullet pool, then everything else only touches itself so is split over threads
+worldSz - objects are kept on or removed when they leave the screen
+input - what the player wants the ship to do
+threads, tasks - optional pool to share the work and scratch space for it
+*/
+void UpdateEntities(Entities& ents, const Dim2Df& worldSz, float elapsed, const Input& input,
+	ThreadPool* threads, TaskBuffers& tasks);
+//handle moving the ship around
+void PlayerControl(Entities& ents, size_t idx, const Dim2Df& worldSz, float elapsed, const Input& input);
+//rocks all move left, returns true once they leave the left edge of the screen and should deactivate
+bool MoveRock(Entities& ents, size_t idx, float elapsed);
+//bullets move right, returns true once they're off the right edge
+bool MoveBullet(Entities& ents, size_t idx, const Dim2Df& worldSz, float elapsed);
+//take a bullet from the pool, set its position to start it flying
+void FireBullet(Entities& ents, float x, float y);
+//reduce health and then deactivate when it hits zero
+void TakeDamage(Entities& ents, size_t idx, int amount);
+
+/*
+Update every object to see if it is colliding with any other - sets the colliding flag true
+Overlap tests are read only so can run on the pool, touching pairs are sorted by
+contact type (see Contacts.h) and each type is responded to in turn, on this thread
+in pair order so the outcome doesn't depend on the thread count. Pairs of types
+that don't affect each other are skipped before the exact test.
+ents - any could be colliding
+threads, tasks - optional pool to share the tests and scratch space for it
+swept - test each entity's whole move from prevX/prevY to x/y, not just where it
+	ended up, and respond to each contact type's hits in the order they happened
+	(see SweptCircleToCircle)
+*/
+void CheckCollisions(Entities& ents, ThreadPool* threads, TaskBuffers& tasks, bool swept = false);
+
+/*
+Same result as CheckCollisions but only tests pairs the broadphase grid says are close
+ents - any could be colliding
+grid - scratch broadphase, rebuilt from the active entities
+*/
+void CheckCollisionsGrid(Entities& ents, SpatialGrid& grid, ThreadPool* threads, TaskBuffers& tasks, bool swept = false);
+
+/*
+A hash of everything the simulation would carry to the next update, for
+checking two runs (e.g. different thread counts) came out identical
+*/
+uint64_t HashState(const Entities& ents);
+
+/*
+Check if two circles are touching
+x1,y1,x2,y2 - two centres
+minDist - minimum colliding distance
+*/
+bool CircleToCircle(float x1, float y1, float x2, float y2, float minDist);
+
+/*
+Check if two circles moving in straight lines touch at any point during the move
+a0,a1 - first circle's centre at the start and end, b0,b1 the same for the second
+minDist - minimum colliding distance
+toi - set to the first time they touch, 0 (start) to 1 (end)
+*/
+bool SweptCircleToCircle(float ax0, float ay0, float ax1, float ay1,
+	float bx0, float by0, float bx1, float by1, float minDist, float& toi);
+
+/*
+Test a circle against every active entity to see if it collides
+x,y,radius - the circle
+skip - an entity to leave out, e.g. the one being placed
+*/
+bool IsColliding(const Entities& ents, float x, float y, float radius, size_t skip = SIZE_MAX);
+
+/*
+Scatter up to count new active rocks over the world, each at least
+GC::ROCK_MIN_DIST of its radius away from anything else. Poisson-disk
+sampling (Bridson) over a PlacementGrid, so each attempt only looks at
+nearby cells and the cost stays close to linear however many rocks there
+are. Stops early once a rock can't find room anywhere.
+*/
+void PlaceRocks(const Dim2Df& worldSz, Entities& ents, Rng& rng, int count = GC::NUM_ROCKS);
+
+/*
+Setup a new rock to fly in from the right
+Take an inactive rock from the pool, pick a new starting position
+for it just off screen to the right. Check it is at least extraClearance units away
+from anything else and leave it active.
+If it does collide with something (or the pool is empty) then don't spawn and return false.
+query - looks for room in nearby grid cells only, null tests every entity
+*/
+bool SpawnRock(const Dim2Df& worldSz, Entities& ents, Rng& rng, float extraClearance, SpawnQuery* query = nullptr);
@@ -0,0 +1,167 @@
+#include <assert.h>
+#include <string.h>
+
+#include "Snapshot.h"
+#include "Profiler.h"
+
+using namespace std;
+
+template<class T>
+uint8_t* PutArray(uint8_t* p, const vector<T>& v, size_t n)
+{
+	if (n)
+		memcpy(p, v.data(), n * sizeof(T));
+	return p + n * sizeof(T);
+}
+
+template<class T>
+const uint8_t* GetArray(const uint8_t* p, vector<T>& v, size_t n)
+{
+	v.resize(n);
+	if (n)
+		memcpy(v.data(), p, n * sizeof(T));
+	return p + n * sizeof(T);
+}
+
+//each entity's arrays, see the layout in Snapshot.h
+const size_t ENTITY_BYTES = 9 * sizeof(float) + sizeof(int32_t) + 2;
+
+size_t SimSnapshot::MaxSize(size_t entities)
+{
+	//every entity could be free at once
+	return sizeof(SnapshotHeader) + entities * (ENTITY_BYTES + sizeof(uint32_t));
+}
+
+void SimSnapshot::Save(const Sim& sim)
+{
+	PROFILE_SCOPE("SimSnapshot::Save");
+	const Entities& ents = sim.ents;
+	const size_t n = ents.Size();
+	static_assert(sizeof(int) == sizeof(int32_t), "health is saved as int32_t");
+	size_t numFree = 0;
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+		numFree += ents.pools[t].free.size();
+	data.resize(sizeof(SnapshotHeader) + n * ENTITY_BYTES + numFree * sizeof(uint32_t));
+
+	SnapshotHeader& h = *(SnapshotHeader*)data.data();
+	h.frame = sim.frame;
+	h.numEnts = (uint32_t)n;
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+	{
+		h.numFree[t] = (uint32_t)ents.pools[t].free.size();
+		h.poolTotal[t] = (uint32_t)ents.pools[t].total;
+	}
+	h.rngState = sim.rng.state;
+	h.spawnTimer = sim.spawnTimer;
+	h.spawnDelay = sim.spawnDelay;
+	h.rockShipClearance = sim.rockShipClearance;
+	h.worldSz = sim.worldSz;
+	h.cfg = sim.cfg;
+
+	uint8_t* p = data.data() + sizeof(SnapshotHeader);
+	p = PutArray(p, ents.x, n);
+	p = PutArray(p, ents.y, n);
+	p = PutArray(p, ents.prevX, n);
+	p = PutArray(p, ents.prevY, n);
+	p = PutArray(p, ents.vx, n);
+	p = PutArray(p, ents.vy, n);
+	p = PutArray(p, ents.radius, n);
+	p = PutArray(p, ents.w, n);
+	p = PutArray(p, ents.h, n);
+	p = PutArray(p, ents.health, n);
+	p = PutArray(p, ents.type, n);
+	p = PutArray(p, ents.flags, n);
+	//indices fit in 32 bits and halve the space
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+		for (size_t i = 0; i < ents.pools[t].free.size(); ++i, p += sizeof(uint32_t))
+		{
+			const uint32_t idx = (uint32_t)ents.pools[t].free[i];
+			memcpy(p, &idx, sizeof(idx));
+		}
+	assert(p == data.data() + data.size());
+}
+
+void SimSnapshot::Restore(Sim& sim) const
+{
+	PROFILE_SCOPE("SimSnapshot::Restore");
+	assert(!Empty());
+	const SnapshotHeader& h = Header();
+	Entities& ents = sim.ents;
+	const size_t n = h.numEnts;
+	sim.frame = h.frame;
+	sim.rng.state = h.rngState;
+	sim.spawnTimer = h.spawnTimer;
+	sim.spawnDelay = h.spawnDelay;
+	sim.rockShipClearance = h.rockShipClearance;
+	sim.worldSz = h.worldSz;
+	sim.cfg = h.cfg;
+
+	const uint8_t* p = data.data() + sizeof(SnapshotHeader);
+	p = GetArray(p, ents.x, n);
+	p = GetArray(p, ents.y, n);
+	p = GetArray(p, ents.prevX, n);
+	p = GetArray(p, ents.prevY, n);
+	p = GetArray(p, ents.vx, n);
+	p = GetArray(p, ents.vy, n);
+	p = GetArray(p, ents.radius, n);
+	p = GetArray(p, ents.w, n);
+	p = GetArray(p, ents.h, n);
+	p = GetArray(p, ents.health, n);
+	p = GetArray(p, ents.type, n);
+	p = GetArray(p, ents.flags, n);
+	for (int t = 0; t < NUM_OBJECT_TYPES; ++t)
+	{
+		vector<size_t>& free = ents.pools[t].free;
+		free.resize(h.numFree[t]);
+		for (size_t i = 0; i < free.size(); ++i, p += sizeof(uint32_t))
+		{
+			uint32_t idx;
+			memcpy(&idx, p, sizeof(idx));
+			free[i] = idx;
+		}
+		ents.pools[t].total = h.poolTotal[t];
+	}
+	assert(p == data.data() + data.size());
+}
+
+void SnapshotRing::Resize(size_t n, size_t entities)
+{
+	slots.resize(n);
+	for (size_t i = 0; i < n; ++i)
+		slots[i].data.reserve(SimSnapshot::MaxSize(entities));
+	newest = 0;
+	count = 0;
+}
+
+void SnapshotRing::Push(const Sim& sim)
+{
+	if (slots.empty())
+		return;
+	newest = count ? (newest + 1) % slots.size() : 0;
+	slots[newest].Save(sim);
+	if (count < slots.size())
+		++count;
+}
+
+const SimSnapshot* SnapshotRing::Get(size_t back) const
+{
+	if (back >= count)
+		return nullptr;
+	return &slots[(newest + slots.size() - back) % slots.size()];
+}
+
+bool SnapshotRing::Rollback(Sim& sim, uint32_t frame)
+{
+	for (size_t back = 0; back < count; ++back)
+	{
+		const SimSnapshot& snap = *Get(back);
+		if (snap.Frame() != frame)
+			continue;
+		snap.Restore(sim);
+		//it and everything newer are pushed again as the updates are re-run
+		newest = (newest + slots.size() - back - 1) % slots.size();
+		count -= back + 1;
+		return true;
+	}
+	return false;
+}
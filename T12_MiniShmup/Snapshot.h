@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Sim.h"
+
+/*
+Everything a Sim carries from one update to the next - the entities, their
+pools, the spawn timer and the random number generator - copied into one
+flat buffer. Scratch that's rebuilt every update (the collision grid, task
+buffers) and anything only for drawing are left out. Restoring puts a Sim
+back exactly as it was, so it plays out the same from there with the same
+inputs. The buffer is kept between saves so once it's big enough saving
+doesn't allocate, and each array is a single memcpy.
+Layout (native endian, only for use within the one process):
+	SnapshotHeader
+	float x, y, prevX, prevY, vx, vy, radius, w, h [numEnts each]
+	int32_t health[numEnts]
+	uint8_t type[numEnts], flags[numEnts]
+	uint32_t free indices, each pool in turn [numFree[t]]
+*/
+
+struct SnapshotHeader
+{
+	uint32_t frame;			//Sim::frame when it was taken
+	uint32_t numEnts;
+	uint32_t numFree[NUM_OBJECT_TYPES];		//length of each pool's free list
+	uint32_t poolTotal[NUM_OBJECT_TYPES];
+	uint64_t rngState;
+	float spawnTimer;
+	float spawnDelay;
+	float rockShipClearance;
+	Dim2Df worldSz;
+	SimConfig cfg;
+};
+
+struct SimSnapshot
+{
+	std::vector<uint8_t> data;	//header then the arrays
+
+	void Save(const Sim& sim);
+	//bytes a snapshot of a Sim with this many entities can take
+	static size_t MaxSize(size_t entities);
+	//sim - goes back to how it was, its scratch and settings (threads, bruteCollisions) are left alone
+	void Restore(Sim& sim) const;
+	bool Empty() const { return data.empty(); }
+	const SnapshotHeader& Header() const { return *(const SnapshotHeader*)data.data(); }
+	uint32_t Frame() const { return Header().frame; }
+};
+
+/*
+The last few updates' snapshots, for rewinding and for rollback - go back
+a few updates, change something and re-simulate forward. Oldest are
+overwritten first, and slots keep their buffers from lap to lap so once
+it's gone round it doesn't allocate.
+*/
+struct SnapshotRing
+{
+	std::vector<SimSnapshot> slots;
+	size_t newest = 0;		//slot of the last Push
+	size_t count = 0;		//slots holding a snapshot
+
+	/*
+	hold up to n, forgets any held now
+	entities - size every slot for a Sim this big (its ents.Size()) so pushing doesn't allocate
+		until a pool grows, 0 grows them as they fill. Not the most the pools could grow to,
+		with a big max that's gigabytes of history that may never be used
+	*/
+	void Resize(size_t n, size_t entities = 0);
+	void Clear() { count = 0; }
+	//snapshot sim into the oldest slot, call before each update
+	void Push(const Sim& sim);
+	//back pushes before the latest, 0 is the latest, null if not held
+	const SimSnapshot* Get(size_t back) const;
+	/*
+	Put sim back to how it was when frame was pushed, then forget that
+	snapshot and everything after it so pushing again while re-simulating
+	carries on from there. False if frame isn't held.
+	*/
+	bool Rollback(Sim& sim, uint32_t frame);
+};
@@ -0,0 +1,220 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "SoftRenderer.h"
+
+using namespace std;
+
+SoftRenderer::SoftRenderer(int width_, int height_, bool rasterize_)
+	: width(width_), height(height_), rasterize(rasterize_)
+{
+	assert(width > 0 && height > 0);
+	pixels.resize((size_t)width * height * 4);
+}
+
+void SoftRenderer::Begin()
+{
+	if (rasterize)
+		memset(&pixels[0], 0, pixels.size());
+	viewScaleX = viewScaleY = 1.f;
+	lastTex = nullptr;
+	anyThisFrame = false;
+	frameDraws = 0;
+}
+
+void SoftRenderer::SetView(float width_, float height_)
+{
+	assert(width_ > 0 && height_ > 0);
+	viewScaleX = width / width_;
+	viewScaleY = height / height_;
+}
+
+void SoftRenderer::Use(RenderTex tex)
+{
+	if (!anyThisFrame || tex != lastTex)
+		++frameDraws;
+	anyThisFrame = true;
+	lastTex = tex;
+}
+
+void SoftRenderer::DrawSprite(const RenderSprite& spr)
+{
+	++sprites;
+	Use(spr.tex);
+	if (!rasterize)
+		return;
+	RenderVertex quad[4];
+	SpriteCorners(spr, quad);
+	RasterQuad((const SoftTexture*)spr.tex, quad, spr.color);
+}
+
+void SoftRenderer::DrawQuad(RenderTex tex, const RenderVertex quad[4], RenderColor col)
+{
+	++quads;
+	Use(tex);
+	if (!rasterize)
+		return;
+	RasterQuad((const SoftTexture*)tex, quad, col);
+}
+
+void SoftRenderer::RasterQuad(const SoftTexture* tex, const RenderVertex quad[4], RenderColor col)
+{
+	RenderVertex v[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		v[i] = quad[i];
+		v[i].x *= viewScaleX;
+		v[i].y *= viewScaleY;
+	}
+	RasterTriangle(tex, v[0], v[1], v[2], col);
+	RasterTriangle(tex, v[0], v[2], v[3], col);
+}
+
+void SoftRenderer::DrawCircle(float x, float y, float radius, RenderColor col)
+{
+	++circles;
+	//shapes aren't batched, each is its own draw
+	++frameDraws;
+	anyThisFrame = false;
+	if (!rasterize)
+		return;
+	x *= viewScaleX;
+	y *= viewScaleY;
+	radius *= viewScaleX;
+	const float outer = radius + 2.f;
+	const int x0 = max(0, (int)floorf(x - outer)), x1 = min(width - 1, (int)ceilf(x + outer));
+	const int y0 = max(0, (int)floorf(y - outer)), y1 = min(height - 1, (int)ceilf(y + outer));
+	for (int py = y0; py <= y1; ++py)
+		for (int px = x0; px <= x1; ++px)
+		{
+			const float dx = px + 0.5f - x, dy = py + 0.5f - y;
+			const float d2 = dx * dx + dy * dy;
+			if (d2 >= radius * radius && d2 < outer * outer)
+				Blend(px, py, col.r, col.g, col.b, col.a);
+		}
+}
+
+int SoftRenderer::End()
+{
+	++frames;
+	drawCalls += frameDraws;
+	return frameDraws;
+}
+
+void SoftRenderer::Blend(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	++pixelsDrawn;
+	uint8_t* p = &pixels[((size_t)y * width + x) * 4];
+	if (a == 255)
+	{
+		p[0] = r;
+		p[1] = g;
+		p[2] = b;
+		return;
+	}
+	const int inv = 255 - a;
+	p[0] = (uint8_t)((r * a + p[0] * inv) / 255);
+	p[1] = (uint8_t)((g * a + p[1] * inv) / 255);
+	p[2] = (uint8_t)((b * a + p[2] * inv) / 255);
+}
+
+/*
+Signed area test, positive when c is to the right of a->b in screen space (y down)
+*/
+float EdgeFunction(float ax, float ay, float bx, float by, float cx, float cy)
+{
+	return (cx - ax) * (by - ay) - (cy - ay) * (bx - ax);
+}
+
+/*
+Pixels exactly on an edge go to the triangle that has it running p->q, a
+neighbour sharing the edge has it the other way round so doesn't get them
+*/
+bool OwnsEdge(const RenderVertex& p, const RenderVertex& q)
+{
+	return p.y < q.y || (p.y == q.y && p.x < q.x);
+}
+
+void SoftRenderer::RasterTriangle(const SoftTexture* tex, const RenderVertex& v0, const RenderVertex& v1, const RenderVertex& v2, RenderColor col)
+{
+	//either winding, flip to one so the inside test has one sign
+	const RenderVertex* a = &v0;
+	const RenderVertex* b = &v1;
+	const RenderVertex* c = &v2;
+	float area = EdgeFunction(a->x, a->y, b->x, b->y, c->x, c->y);
+	if (area == 0)
+		return;
+	if (area < 0)
+	{
+		swap(b, c);
+		area = -area;
+	}
+
+	const int x0 = max(0, (int)floorf(min(a->x, min(b->x, c->x))));
+	const int x1 = min(width - 1, (int)ceilf(max(a->x, max(b->x, c->x))));
+	const int y0 = max(0, (int)floorf(min(a->y, min(b->y, c->y))));
+	const int y1 = min(height - 1, (int)ceilf(max(a->y, max(b->y, c->y))));
+	const bool own0 = OwnsEdge(*b, *c), own1 = OwnsEdge(*c, *a), own2 = OwnsEdge(*a, *b);
+	//the edge functions are linear so step them across each row
+	const float step0 = c->y - b->y, step1 = a->y - c->y, step2 = b->y - a->y;
+	const float invArea = 1.f / area;
+	for (int py = y0; py <= y1; ++py)
+	{
+		//sample at pixel centres
+		const float sx = x0 + 0.5f, sy = py + 0.5f;
+		float w0 = EdgeFunction(b->x, b->y, c->x, c->y, sx, sy);
+		float w1 = EdgeFunction(c->x, c->y, a->x, a->y, sx, sy);
+		float w2 = EdgeFunction(a->x, a->y, b->x, b->y, sx, sy);
+		for (int px = x0; px <= x1; ++px, w0 += step0, w1 += step1, w2 += step2)
+		{
+			//pixels exactly on an edge only belong to one triangle so
+			//the two halves of a quad don't blend the diagonal twice
+			if (w0 < 0 || w1 < 0 || w2 < 0 || (w0 == 0 && !own0) || (w1 == 0 && !own1) || (w2 == 0 && !own2))
+				continue;
+
+			uint8_t r = col.r, g = col.g, bl = col.b, al = col.a;
+			if (tex && tex->width > 0)
+			{
+				const float u = (w0 * a->u + w1 * b->u + w2 * c->u) * invArea;
+				const float v = (w0 * a->v + w1 * b->v + w2 * c->v) * invArea;
+				const int tu = min(max((int)u, 0), tex->width - 1);
+				const int tv = min(max((int)v, 0), tex->height - 1);
+				const uint8_t* t = &tex->rgba[((size_t)tv * tex->width + tu) * 4];
+				r = (uint8_t)(t[0] * col.r / 255);
+				g = (uint8_t)(t[1] * col.g / 255);
+				bl = (uint8_t)(t[2] * col.b / 255);
+				al = (uint8_t)(t[3] * col.a / 255);
+			}
+			if (al)
+				Blend(px, py, r, g, bl, al);
+		}
+	}
+}
+
+uint64_t SoftRenderer::Hash() const
+{
+	//FNV-1a
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < pixels.size(); ++i)
+	{
+		h ^= pixels[i];
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+bool SoftRenderer::SavePPM(const string& path) const
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	if (!f)
+		return false;
+	fprintf(f, "P6\n%d %d\n255\n", width, height);
+	bool ok = true;
+	for (size_t i = 0; ok && i < pixels.size(); i += 4)
+		ok = fwrite(&pixels[i], 3, 1, f) == 1;
+	return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "RenderBackend.h"
+
+/*
+Pixels for SoftRenderer, pass a pointer to one as the RenderTex
+*/
+struct SoftTexture
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> rgba;	//width * height * 4, rows top to bottom
+};
+
+/*
+Renders with no GPU or display - counts every submission and, unless
+rasterize is off (a null renderer), draws into an in memory RGBA image
+with nearest sampling and alpha blending. The image hash makes a quick
+check that a change didn't alter the output.
+*/
+struct SoftRenderer : RenderBackend
+{
+	int width = 0;
+	int height = 0;
+	bool rasterize = true;			//false just counts, for timing submission alone
+	std::vector<uint8_t> pixels;	//width * height * 4 RGBA, the last frame, cleared to transparent black
+
+	//totals since construction
+	uint64_t frames = 0;
+	uint64_t sprites = 0;
+	uint64_t quads = 0;
+	uint64_t circles = 0;
+	uint64_t drawCalls = 0;			//texture changes, as SfmlRenderer would need
+	uint64_t pixelsDrawn = 0;
+
+	SoftRenderer(int width_, int height_, bool rasterize_);
+
+	void Begin() override;
+	void SetView(float width, float height) override;
+	void DrawSprite(const RenderSprite& spr) override;
+	void DrawQuad(RenderTex tex, const RenderVertex quad[4], RenderColor col) override;
+	void DrawCircle(float x, float y, float radius, RenderColor col) override;
+	int End() override;
+
+	//hash of the image so far
+	uint64_t Hash() const;
+	//write the image as a binary PPM, alpha dropped
+	bool SavePPM(const std::string& path) const;
+
+private:
+	void Blend(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+	//scale by the view and draw as two triangles
+	void RasterQuad(const SoftTexture* tex, const RenderVertex quad[4], RenderColor col);
+	void RasterTriangle(const SoftTexture* tex, const RenderVertex& v0, const RenderVertex& v1, const RenderVertex& v2, RenderColor col);
+	//count a draw call when the texture changes, like a batching renderer
+	void Use(RenderTex tex);
+
+	float viewScaleX = 1.f;		//pixels per unit, from SetView
+	float viewScaleY = 1.f;
+	RenderTex lastTex = nullptr;
+	bool anyThisFrame = false;
+	int frameDraws = 0;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdint.h>
+
+/*
+Bubble sorter, kept as the baseline for T12_Bench - use SortByZ
+items - a vector of anything with a z member to sort by, e.g. Background
+*/
+template<class T>
+void Bubble(std::vector<T>& items)
+{
+	bool busy = true;
+	while (busy)
+	{
+		busy = false;
+		for (size_t i = 0; i < (items.size() - 1); ++i)
+		{
+			if (items[i].z > items[i + 1].z)
+			{
+				std::swap(items[i], items[i + 1]);
+				busy = true;
+			}
+		}
+	}
+}
+
+/*
+Sort by z, lowest first, keeping the order of equal z (same result as Bubble).
+Sorts small keys then moves each item once into place, so it works on
+move only types and never copies one.
+items - a vector of anything with a z member to sort by, e.g. Background
+*/
+template<class T>
+void SortByZ(std::vector<T>& items)
+{
+	struct Key
+	{
+		float z;
+		uint32_t idx;
+		bool operator<(const Key& rhs) const { return z < rhs.z || (z == rhs.z && idx < rhs.idx); }
+	};
+	std::vector<Key> keys(items.size());
+	for (size_t i = 0; i < items.size(); ++i)
+		keys[i] = Key{ items[i].z, (uint32_t)i };
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<T> sorted;
+	sorted.reserve(items.size());
+	for (size_t i = 0; i < keys.size(); ++i)
+		sorted.push_back(std::move(items[keys[i].idx]));
+	items.swap(sorted);
+}
@@ -0,0 +1,154 @@
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+
+#include "SpatialGrid.h"
+
+using namespace std;
+
+/*
+Stop a few far away circles blowing up the cell count, the grid never
+has more than this many cells per circle (plus a little slack)
+*/
+const int MAX_CELLS_PER_ITEM = 4;
+
+void SpatialGrid::Clear()
+{
+	xs.clear();
+	ys.clear();
+	rs.clear();
+	ids.clear();
+	pairs.clear();
+}
+
+void SpatialGrid::Reserve(size_t circles)
+{
+	xs.reserve(circles);
+	ys.reserve(circles);
+	rs.reserve(circles);
+	ids.reserve(circles);
+	//Build can round up a little past its cap on cells, leave it room
+	cellStart.reserve(2 * (circles * MAX_CELLS_PER_ITEM + 64) + 1);
+	cellItems.reserve(circles);
+	itemCell.reserve(circles);
+}
+
+void SpatialGrid::Add(float x, float y, float r, int id)
+{
+	assert(id >= 0);
+	xs.push_back(x);
+	ys.push_back(y);
+	rs.push_back(r);
+	ids.push_back(id);
+}
+
+void SpatialGrid::Build()
+{
+	const int count = (int)xs.size();
+	cols = rows = 0;
+	if (count == 0)
+		return;
+
+	float minX = xs[0], maxX = xs[0];
+	float minY = ys[0], maxY = ys[0];
+	float maxR = rs[0];
+	for (int i = 1; i < count; ++i)
+	{
+		minX = min(minX, xs[i]);
+		maxX = max(maxX, xs[i]);
+		minY = min(minY, ys[i]);
+		maxY = max(maxY, ys[i]);
+		maxR = max(maxR, rs[i]);
+	}
+
+	//two touching circles are at most 2*maxR apart so they can only be one cell apart
+	cellSize = max(2.f * maxR, 1.f);
+	const float maxCells = (float)(count * MAX_CELLS_PER_ITEM + 64);
+	float area = ((maxX - minX) / cellSize + 1.f) * ((maxY - minY) / cellSize + 1.f);
+	if (area > maxCells)
+		cellSize *= sqrtf(area / maxCells);
+	originX = minX;
+	originY = minY;
+	maxRadius = maxR;
+	cols = (int)((maxX - minX) / cellSize) + 1;
+	rows = (int)((maxY - minY) / cellSize) + 1;
+
+	//counting sort circles into cells
+	const int numCells = cols * rows;
+	cellStart.assign(numCells + 1, 0);
+	itemCell.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		int cx = min((int)((xs[i] - originX) / cellSize), cols - 1);
+		int cy = min((int)((ys[i] - originY) / cellSize), rows - 1);
+		itemCell[i] = cy * cols + cx;
+		++cellStart[itemCell[i] + 1];
+	}
+	for (int c = 0; c < numCells; ++c)
+		cellStart[c + 1] += cellStart[c];
+	cellItems.resize(count);
+	for (int i = 0; i < count; ++i)
+		cellItems[cellStart[itemCell[i]]++] = i;
+	//the fill loop left each start pointing at the next cell, shift back
+	for (int c = numCells; c > 0; --c)
+		cellStart[c] = cellStart[c - 1];
+	cellStart[0] = 0;
+}
+
+void SpatialGrid::Query(float x, float y, float r, vector<int>& out) const
+{
+	if (NumCells() == 0)
+		return;
+	//a little extra so rounding can't drop a circle right on the edge of reach
+	const float reach = r + maxRadius + 1.f;
+	const int x0 = max(0, (int)floorf((x - reach - originX) / cellSize));
+	const int x1 = min(cols - 1, (int)floorf((x + reach - originX) / cellSize));
+	const int y0 = max(0, (int)floorf((y - reach - originY) / cellSize));
+	const int y1 = min(rows - 1, (int)floorf((y + reach - originY) / cellSize));
+	for (int cy = y0; cy <= y1; ++cy)
+		for (int cx = x0; cx <= x1; ++cx)
+		{
+			const int c = cy * cols + cx;
+			for (int i = cellStart[c]; i < cellStart[c + 1]; ++i)
+				out.push_back(ids[cellItems[i]]);
+		}
+}
+
+void SpatialGrid::FindPairs()
+{
+	pairs.clear();
+	FindPairs(0, NumCells(), pairs);
+	for (size_t p = 0; p < pairs.size(); ++p)
+		pairs[p] = MakePair(PairLow(pairs[p]), PairHigh(pairs[p]));
+	//same order the brute force loop visits pairs in, so hit responses match
+	sort(pairs.begin(), pairs.end());
+}
+
+void SpatialGrid::FindPairs(int cellBegin, int cellEnd, vector<uint64_t>& out) const
+{
+	assert(cellBegin >= 0 && cellEnd <= NumCells());
+	//only look forward (same cell, right, and the row below) so each pair is found once
+	const int NUM_NEIGHBOURS = 4;
+	const int offX[NUM_NEIGHBOURS] = { 1, -1, 0, 1 };
+	const int offY[NUM_NEIGHBOURS] = { 0, 1, 1, 1 };
+
+	for (int c = cellBegin; c < cellEnd; ++c)
+	{
+		const int cx = c % cols, cy = c / cols;
+		for (int i = cellStart[c]; i < cellStart[c + 1]; ++i)
+		{
+			const uint64_t a = (uint64_t)ids[cellItems[i]] << 32;
+			for (int ii = i + 1; ii < cellStart[c + 1]; ++ii)
+				out.push_back(a | (uint32_t)ids[cellItems[ii]]);
+			for (int n = 0; n < NUM_NEIGHBOURS; ++n)
+			{
+				const int nx = cx + offX[n], ny = cy + offY[n];
+				if (nx < 0 || nx >= cols || ny >= rows)
+					continue;
+				const int nc = ny * cols + nx;
+				for (int ii = cellStart[nc]; ii < cellStart[nc + 1]; ++ii)
+					out.push_back(a | (uint32_t)ids[cellItems[ii]]);
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+/*
+Uniform grid broadphase (spatial hash), rebuilt from scratch every frame.
+Each circle is binned by its centre into a cell at least as wide as the
+largest diameter, so any two touching circles are in the same or adjacent
+cells. Only those pairs are handed back as candidates for the narrow phase.
+Usage: Clear, Add every active circle, Build, FindPairs, then read pairs.
+Or to split the work across threads, each takes a range of cells and calls
+the const FindPairs overload with its own output vector.
+Once built, Query finds what's near any other circle, e.g. for spawning.
+*/
+struct SpatialGrid
+{
+	float cellSize = 0;			//width and height of a cell, set by Build
+	float originX = 0;			//world position of the top left cell
+	float originY = 0;
+	int cols = 0;				//grid dimensions in cells
+	int rows = 0;
+	float maxRadius = 0;		//largest circle added, set by Build
+
+	std::vector<float> xs;		//circles added since the last Clear
+	std::vector<float> ys;
+	std::vector<float> rs;
+	std::vector<int> ids;		//caller's id for each circle
+	std::vector<int> cellStart;	//index into cellItems where each cell starts, one extra at the end
+	std::vector<int> cellItems;	//circle indices ordered by cell
+	std::vector<int> itemCell;	//cell each circle landed in
+	std::vector<uint64_t> pairs;	//candidate pairs of ids packed low<<32|high, sorted ascending
+
+	//forget all circles, keeps memory for the next frame
+	void Clear();
+	//make room to Add and Build up to this many circles without allocating
+	void Reserve(size_t circles);
+	//add a circle, id comes back out in pairs
+	void Add(float x, float y, float r, int id);
+	//size the grid to fit everything added and bin each circle
+	void Build();
+	//fill pairs with every pair of circles in the same or neighbouring cells
+	void FindPairs();
+	/*
+	append candidate pairs for the circles binned in cells [cellBegin, cellEnd)
+	out - pairs packed first<<32|other, unsorted but grouped by first id
+	*/
+	void FindPairs(int cellBegin, int cellEnd, std::vector<uint64_t>& out) const;
+	int NumCells() const { return cols * rows; }
+	/*
+	append the ids of every circle that could be touching this one, i.e. binned
+	in a cell within r + maxRadius of its centre, call after Build
+	*/
+	void Query(float x, float y, float r, std::vector<int>& out) const;
+
+	//pack a pair of ids, smaller one first
+	static uint64_t MakePair(int a, int b) { return a < b ? ((uint64_t)a << 32 | (uint32_t)b) : ((uint64_t)b << 32 | (uint32_t)a); }
+	//unpack a pair
+	static int PairLow(uint64_t p) { return (int)(p >> 32); }
+	static int PairHigh(uint64_t p) { return (int)(p & 0xffffffff); }
+};
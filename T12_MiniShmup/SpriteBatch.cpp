@@ -0,0 +1,83 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "SpriteBatch.h"
+
+using namespace std;
+using namespace sf;
+
+void SpriteBatch::Clear()
+{
+	for (size_t i = 0; i < batches.size(); ++i)
+		batches[i].verts.clear();
+}
+
+void SpriteBatch::Add(const Sprite& spr)
+{
+	assert(spr.getTexture());
+	Add(*spr.getTexture(), spr.getTransform(), spr.getTextureRect(), spr.getColor());
+}
+
+/*
+The batch for a texture, made the first time it's asked for
+*/
+vector<Vertex>& BatchVerts(vector<SpriteBatch::Batch>& batches, const Texture* tex)
+{
+	size_t b = 0;
+	while (b < batches.size() && batches[b].tex != tex)
+		++b;
+	if (b == batches.size())
+	{
+		batches.push_back(SpriteBatch::Batch());
+		batches[b].tex = tex;
+	}
+	return batches[b].verts;
+}
+
+void SpriteBatch::Add(const Texture& tex, const Transform& xform, const IntRect& texRect, Color col)
+{
+
+	//same corners and texture coordinates sf::Sprite uses
+	const float w = (float)abs(texRect.width);
+	const float h = (float)abs(texRect.height);
+	const float left = (float)texRect.left;
+	const float right = left + texRect.width;
+	const float top = (float)texRect.top;
+	const float bottom = top + texRect.height;
+	vector<Vertex>& verts = BatchVerts(batches, &tex);
+	verts.push_back(Vertex(xform.transformPoint(0, 0), col, Vector2f(left, top)));
+	verts.push_back(Vertex(xform.transformPoint(0, h), col, Vector2f(left, bottom)));
+	verts.push_back(Vertex(xform.transformPoint(w, h), col, Vector2f(right, bottom)));
+	verts.push_back(Vertex(xform.transformPoint(w, 0), col, Vector2f(right, top)));
+}
+
+void SpriteBatch::AddQuad(const Texture* tex, const Vertex quad[4])
+{
+	vector<Vertex>& verts = BatchVerts(batches, tex);
+	verts.insert(verts.end(), quad, quad + 4);
+}
+
+int SpriteBatch::Draw(RenderTarget& target) const
+{
+	int draws = 0;
+	for (size_t i = 0; i < batches.size(); ++i)
+	{
+		const Batch& b = batches[i];
+		if (!b.verts.empty())
+		{
+			RenderStates states;
+			states.texture = b.tex;
+			target.draw(&b.verts[0], b.verts.size(), Quads, states);
+			++draws;
+		}
+	}
+	return draws;
+}
+
+size_t SpriteBatch::NumQuads() const
+{
+	size_t num = 0;
+	for (size_t i = 0; i < batches.size(); ++i)
+		num += batches[i].verts.size() / 4;
+	return num;
+}
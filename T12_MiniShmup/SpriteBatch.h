@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "SFML/Graphics.hpp"
+
+/*
+Collects sprites into one quad list per texture so a frame's worth of
+objects goes to the GPU in a handful of draws instead of one each.
+Building the vertices is all CPU side (no window or GL context needed),
+only Draw touches the render target. T12_SpriteBatchCheck checks the
+quads it builds without a GPU.
+Usage: Clear, Add each sprite, Draw.
+*/
+struct SpriteBatch
+{
+	struct Batch
+	{
+		const sf::Texture* tex = nullptr;	//everything in this batch uses it
+		std::vector<sf::Vertex> verts;		//4 per sprite, drawn as sf::Quads
+	};
+	std::vector<Batch> batches;	//drawn in the order each texture was first added, kept between frames
+
+	//empty every batch, keeps the memory
+	void Clear();
+	//add a sprite as it would be drawn with window.draw(spr)
+	void Add(const sf::Sprite& spr);
+	/*
+	add a textured quad
+	tex - texture to sample
+	xform - local to world transform, the quad's local corners are 0,0 to texRect size
+	texRect - area of tex to show
+	*/
+	void Add(const sf::Texture& tex, const sf::Transform& xform, const sf::IntRect& texRect, sf::Color col = sf::Color::White);
+	/*
+	add a quad that's already been placed
+	tex - texture to sample, null for plain colour
+	quad - corners top left, bottom left, bottom right, top right
+	*/
+	void AddQuad(const sf::Texture* tex, const sf::Vertex quad[4]);
+	//one draw per texture with anything in it, returns how many draws were made
+	int Draw(sf::RenderTarget& target) const;
+	//total sprites added since Clear
+	size_t NumQuads() const;
+};
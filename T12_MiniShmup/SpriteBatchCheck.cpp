@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SpriteBatch.h"
+#include "SFML/Graphics.hpp"
+
+using namespace std;
+using namespace sf;
+
+/*
+Checks the quads SpriteBatch builds, without a window or GPU: the textures
+are never loaded, they only tell the batches apart.
+Usage: T12_SpriteBatchCheck
+Prints each failure and exits with EXIT_FAILURE if there were any.
+*/
+
+int failures = 0;
+
+void Check(bool ok, const char* what)
+{
+	if (!ok)
+	{
+		printf("FAILED %s\n", what);
+		++failures;
+	}
+}
+
+bool Near(const Vector2f& a, float x, float y)
+{
+	const float EPS = 1e-3f;
+	return fabsf(a.x - x) < EPS && fabsf(a.y - y) < EPS;
+}
+
+/*
+One quad against its expected corners (top left, bottom left, bottom right,
+top right) and texture coordinates
+*/
+void CheckQuad(const Vertex* v, const float pos[8], const float tex[8], const char* what)
+{
+	for (int c = 0; c < 4; ++c)
+	{
+		Check(Near(v[c].position, pos[c * 2], pos[c * 2 + 1]), what);
+		Check(Near(v[c].texCoords, tex[c * 2], tex[c * 2 + 1]), what);
+	}
+}
+
+//batches with anything in them
+int UsedBatches(const SpriteBatch& batch)
+{
+	int used = 0;
+	for (size_t i = 0; i < batch.batches.size(); ++i)
+		used += batch.batches[i].verts.empty() ? 0 : 1;
+	return used;
+}
+
+int main()
+{
+	Texture texA, texB;
+	SpriteBatch batch;
+
+	//a run of two on A then one on B, as SfmlRenderer hands them over between flushes
+	Sprite spr(texA, IntRect(0, 0, 32, 16));
+	spr.setPosition(10, 20);
+	batch.Add(spr);
+	Transform scaled;
+	scaled.translate(100, 50).scale(2, 2);
+	batch.Add(texA, scaled, IntRect(8, 4, 16, 8));
+	Transform turned;
+	turned.rotate(90);
+	batch.Add(texB, turned, IntRect(0, 0, 10, 20), Color::Red);
+
+	Check(batch.NumQuads() == 3, "three quads added");
+	Check(UsedBatches(batch) == 2, "one batch per texture run");
+	Check(batch.batches[0].tex == &texA && batch.batches[1].tex == &texB, "batches in the order textures were first added");
+	Check(batch.batches[0].verts.size() == 8 && batch.batches[1].verts.size() == 4, "four vertices per quad");
+	if (failures)
+		return EXIT_FAILURE;
+
+	const float sprPos[8] = { 10, 20, 10, 36, 42, 36, 42, 20 };
+	const float sprTex[8] = { 0, 0, 0, 16, 32, 16, 32, 0 };
+	CheckQuad(&batch.batches[0].verts[0], sprPos, sprTex, "sprite at a position");
+	const float scaledPos[8] = { 100, 50, 100, 66, 132, 66, 132, 50 };
+	const float scaledTex[8] = { 8, 4, 8, 12, 24, 12, 24, 4 };
+	CheckQuad(&batch.batches[0].verts[4], scaledPos, scaledTex, "translated and scaled quad");
+	//90 degrees clockwise (y down) takes x along +y and y along -x
+	const float turnedPos[8] = { 0, 0, -20, 0, -20, 10, 0, 10 };
+	const float turnedTex[8] = { 0, 0, 0, 20, 10, 20, 10, 0 };
+	CheckQuad(&batch.batches[1].verts[0], turnedPos, turnedTex, "rotated quad");
+	Check(batch.batches[1].verts[0].color == Color::Red, "colour carried to the vertices");
+
+	//A again after B goes back in A's batch, the batch list doesn't grow
+	batch.Add(texA, Transform(), IntRect(0, 0, 4, 4));
+	Check(batch.batches.size() == 2 && batch.batches[0].verts.size() == 12, "texture seen before reuses its batch");
+
+	//Clear empties every batch but keeps them for the next frame
+	batch.Clear();
+	Check(batch.NumQuads() == 0 && UsedBatches(batch) == 0, "clear empties the batches");
+	Check(batch.batches.size() == 2, "clear keeps the batches");
+	batch.Add(texB, Transform(), IntRect(0, 0, 4, 4));
+	Check(UsedBatches(batch) == 1 && batch.batches[1].verts.size() == 4, "refilled after clear");
+
+	if (failures)
+		return EXIT_FAILURE;
+	printf("SpriteBatch OK\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "TextureCache.h"
+#include "AssetBundle.h"
+#include "AssetLoader.h"
+#include "Game.h"
+
+using namespace std;
+using namespace sf;
+
+bool TextureCache::LoadBundle(const string& file)
+{
+	AssetBundle bundle;
+	if (!bundle.Open(file))
+		return false;
+
+	//straight from the mapping to the GPU, no decoding
+	const BundleHeader& h = *bundle.header;
+	TextureHandle tex = make_shared<Texture>();
+	if (!tex->create(h.width, h.height))
+		return false;
+	tex->update(bundle.pixels);
+	tex->setSmooth(true);
+	++loads;
+
+	atlas = tex;
+	atlasRects.clear();
+	for (uint32_t i = 0; i < h.numEntries; ++i)
+	{
+		const BundleEntry& e = bundle.entries[i];
+		const char* end = (const char*)memchr(e.name, 0, BUNDLE_NAME_LEN);
+		string name(e.name, end ? end - e.name : BUNDLE_NAME_LEN);
+		atlasRects[name] = IntRect(e.x, e.y, e.w, e.h);
+	}
+	return true;
+}
+
+TextureHandle TextureCache::Get(const string& file)
+{
+	map<string, TextureHandle>::iterator it = textures.find(file);
+	if (it != textures.end())
+		return it->second;
+
+	TextureHandle tex = make_shared<Texture>();
+	Vector2u size;
+	if (loader && ReadPngSize(file, size.x, size.y))
+	{
+		const Uint8 clear[4] = { 0, 0, 0, 0 };
+		tex->create(1, 1);
+		tex->update(clear);
+		pending[file] = size;
+		loader->Request(file);
+		++requested;
+	}
+	else
+	{
+		LoadTexture(file, *tex);
+		++loads;
+	}
+	textures[file] = tex;
+	return tex;
+}
+
+TextureRegion TextureCache::GetRegion(const string& file)
+{
+	TextureRegion region;
+	map<string, IntRect>::const_iterator it = atlasRects.find(file);
+	if (atlas && it != atlasRects.end())
+	{
+		region.tex = atlas;
+		region.rect = it->second;
+	}
+	else
+	{
+		region.tex = Get(file);
+		//a placeholder's own size is one pixel, use what the image will be
+		map<string, Vector2u>::const_iterator p = pending.find(file);
+		const Vector2u size = p != pending.end() ? p->second : region.tex->getSize();
+		region.rect = IntRect(0, 0, (int)size.x, (int)size.y);
+	}
+	return region;
+}
+
+int TextureCache::Upload(int maxUploads)
+{
+	int uploaded = 0;
+	AssetLoader::Decoded d;
+	while (loader && uploaded < maxUploads && loader->Pop(d))
+	{
+		map<string, Vector2u>::iterator p = pending.find(d.file);
+		assert(p != pending.end());
+		if (d.image)
+		{
+			Texture& tex = *textures[d.file];
+			tex.loadFromImage(*d.image);
+			tex.setSmooth(true);
+			assert(tex.getSize() == p->second);
+			++loads;
+			++uploaded;
+		}
+		else
+		{
+			//stays an invisible placeholder rather than stopping the game
+			printf("Couldn't load %s\n", d.file.c_str());
+			assert(false);
+		}
+		decodeMs += d.decodeMs;
+		pending.erase(p);
+	}
+	return uploaded;
+}
+
+void SetRegion(Sprite& spr, const TextureRegion& region)
+{
+	spr.setTexture(*region.tex);
+	spr.setTextureRect(region.rect);
+}
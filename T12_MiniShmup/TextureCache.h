@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include "SFML/Graphics.hpp"
+
+struct AssetLoader;
+
+//shared ownership of a texture, copying one doesn't copy any pixels
+typedef std::shared_ptr<sf::Texture> TextureHandle;
+
+/*
+Where an image ended up - a whole texture of its own or part of the atlas
+*/
+struct TextureRegion
+{
+	TextureHandle tex;
+	sf::IntRect rect;	//area of tex holding the image
+};
+
+/*
+Every texture the game uses, keyed by file path.
+Each file is loaded from disk and uploaded once, after that everyone
+asking for the same path gets a handle to the same texture. If an asset
+bundle has been loaded, images packed in it come from the shared atlas
+instead and never touch their PNG.
+
+With a loader set, a PNG asked for the first time isn't loaded there and
+then - Get hands back a placeholder straight away (a transparent pixel, so
+it draws nothing) and the file is decoded on the loader's threads. Upload
+later puts the image into that same texture, so every handle and sprite
+already pointing at it just starts showing the real thing. The size comes
+from the PNG header so regions and layout are right from the start.
+*/
+struct TextureCache
+{
+	std::map<std::string, TextureHandle> textures;	//path -> loaded texture, or its placeholder
+	TextureHandle atlas;							//from the asset bundle, if there is one
+	std::map<std::string, sf::IntRect> atlasRects;	//path -> where it is in the atlas
+	int loads = 0;									//how many times we actually went to disk
+	AssetLoader* loader = nullptr;					//not owned, decode new files on its threads, null loads them in Get
+	std::map<std::string, sf::Vector2u> pending;	//path -> size, handed to loader and not uploaded yet
+	int requested = 0;								//files ever handed to loader
+	double decodeMs = 0;							//loader time spent on the files uploaded so far
+
+	/*
+	Map a bundle made by T12_AssetPacker and upload its atlas
+	false if there isn't one (or it's bad), images then load individually
+	*/
+	bool LoadBundle(const std::string& file);
+	//the texture for this file, loading it (or starting to) on first use
+	TextureHandle Get(const std::string& file);
+	//the atlas area for this file if it was bundled, otherwise the whole of its own texture
+	TextureRegion GetRegion(const std::string& file);
+	/*
+	Move images the loader has finished into their placeholders, main thread only
+	maxUploads - most to send to the GPU this call, the rest wait for the next
+	returns how many were uploaded
+	*/
+	int Upload(int maxUploads);
+	//true while anything handed to the loader hasn't been uploaded
+	bool Loading() const { return !pending.empty(); }
+	//0 to 1, how much of what's been handed to the loader is in
+	float Progress() const { return requested ? 1.f - (float)pending.size() / requested : 1.f; }
+};
+
+/*
+Point a sprite at a region, the texture rect is set to cover it
+*/
+void SetRegion(sf::Sprite& spr, const TextureRegion& region);
@@ -0,0 +1,97 @@
+#include <assert.h>
+#include <algorithm>
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	assert(numThreads >= 1);
+	for (int i = 1; i < numThreads; ++i)
+		workers.push_back(thread(&ThreadPool::WorkerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock(mtx);
+		quit = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+}
+
+void ThreadPool::Run(size_t count, TaskFn fn, void* ctx)
+{
+	if (count == 0)
+		return;
+	Job mine;
+	{
+		lock_guard<mutex> lock(mtx);
+		mine.fn = fn;
+		mine.ctx = ctx;
+		mine.count = count;
+		mine.tasks = (int)min((size_t)MaxTasks(), count);
+		mine.generation = ++generation;
+		job = mine;
+		//the count goes in before the tasks are up for grabs
+		tasksLeft = mine.tasks;
+		nextTask = (uint64_t)mine.generation << 32;
+	}
+	wake.notify_all();
+
+	DoTasks(mine);
+
+	unique_lock<mutex> lock(mtx);
+	finished.wait(lock, [this] { return tasksLeft == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned seen = 0;
+	while (true)
+	{
+		Job current;
+		{
+			unique_lock<mutex> lock(mtx);
+			wake.wait(lock, [this, seen] { return quit || generation != seen; });
+			if (quit)
+				return;
+			seen = generation;
+			current = job;
+		}
+		DoTasks(current);
+	}
+}
+
+void ThreadPool::DoTasks(const Job& j)
+{
+	while (true)
+	{
+		//claim the next task, only while it's still this job's
+		uint64_t next = nextTask.load();
+		do
+		{
+			if ((unsigned)(next >> 32) != j.generation || (int)(uint32_t)next >= j.tasks)
+				return;
+		} while (!nextTask.compare_exchange_weak(next, next + 1));
+		const int task = (int)(uint32_t)next;
+
+		//even split of the range, the first few tasks take one extra if it doesn't divide
+		const size_t per = j.count / j.tasks, extra = j.count % j.tasks;
+		const size_t begin = task * per + min((size_t)task, extra);
+		const size_t end = begin + per + ((size_t)task < extra ? 1 : 0);
+		{
+			PROFILE_SCOPE("ThreadPool task");
+			j.fn(j.ctx, begin, end, task);
+		}
+		if (tasksLeft.fetch_sub(1) == 1)
+		{
+			lock_guard<mutex> lock(mtx);
+			finished.notify_all();
+		}
+	}
+}
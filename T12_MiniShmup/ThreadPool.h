@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+A fixed set of worker threads for splitting loops over entities.
+The calling thread works too, so a pool of N threads starts N-1 workers.
+Work is handed out as numbered tasks (contiguous index ranges); anything
+order dependent should write into per task buffers and merge them in task
+order afterwards, then the result is the same however many threads ran it.
+*/
+struct ThreadPool
+{
+	static const int TASKS_PER_THREAD = 4;	//smaller tasks than threads so uneven work balances out
+
+	explicit ThreadPool(int numThreads);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//including the caller
+	int NumThreads() const { return (int)workers.size() + 1; }
+	//most tasks a job gets split into, size per task buffers to this
+	int MaxTasks() const { return NumThreads() * TASKS_PER_THREAD; }
+
+	/*
+	Split [0, count) into tasks and run fn(begin, end, task) over them on every thread
+	returns when they're all done, fn must be safe to call from several threads at once
+	*/
+	template<class Fn>
+	void Run(size_t count, Fn& fn) { Run(count, &CallFn<Fn>, &fn); }
+
+private:
+	typedef void(*TaskFn)(void* ctx, size_t begin, size_t end, int task);
+	template<class Fn>
+	static void CallFn(void* ctx, size_t begin, size_t end, int task) { (*(Fn*)ctx)(begin, end, task); }
+
+	//one Run, copied under the lock by each thread that joins it
+	struct Job
+	{
+		TaskFn fn = nullptr;
+		void* ctx = nullptr;
+		size_t count = 0;
+		int tasks = 0;
+		unsigned generation = 0;	//which Run this is, a thread only takes tasks from the one it joined
+	};
+
+	void Run(size_t count, TaskFn fn, void* ctx);
+	void WorkerLoop();
+	//grab and run tasks from job until there are none left or a newer job has started
+	void DoTasks(const Job& job);
+
+	std::vector<std::thread> workers;
+	std::mutex mtx;
+	std::condition_variable wake;		//workers wait here for a job
+	std::condition_variable finished;	//Run waits here for the last task
+	bool quit = false;
+	unsigned generation = 0;			//bumped for every job so workers know there's a new one
+
+	Job job;							//the current job, only touched under mtx
+	std::atomic<uint64_t> nextTask{ 0 };	//generation << 32 | next task to hand out, so a late thread can't take one from a newer job
+	std::atomic<int> tasksLeft{ 0 };	//tasks of the current job not finished yet
+};
+
+/*
+Run fn(begin, end, task) over [0, count), on the pool if there is one and the job
+is big enough to be worth it (at least minPerTask items per task), otherwise as a
+single task 0 on this thread
+*/
+template<class Fn>
+void ParallelFor(ThreadPool* pool, size_t count, size_t minPerTask, Fn&& fn)
+{
+	if (!pool || pool->NumThreads() == 1 || count < 2 * minPerTask)
+	{
+		if (count)
+			fn((size_t)0, count, 0);
+	}
+	else
+		pool->Run(count, fn);
+}
+
+//how many per task buffers ParallelFor needs
+inline int MaxTasks(const ThreadPool* pool) { return pool ? pool->MaxTasks() : 1; }
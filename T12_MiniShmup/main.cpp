@@ -1,58 +1,154 @@
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
 #include <string>
 #include "Game.h"
+#include "InputState.h"
+#include "Profiler.h"
+#include "FramePacer.h"
+#include "AllocTracker.h"
+#include "SfmlRenderer.h"
 #include "SFML/Graphics.hpp"
 
 using namespace sf;
 using namespace std;
 
-int main()
+/*
+Usage: T12_MiniShmup [-tickrate updates_per_second] [-fps N] [-threads N] [-seed N] [-record file] [-trace file]
+	[-config file] [-rocks N] [-max-rocks N] [-bullets N] [-max-bullets N] [-stress N] [-swept 0|1]
+	[-spawn-delay s] [-rock-clearance N] [-rock-speed N] [-bg-min N] [-bg-max N]
+Backspace rewinds the game a second, up to three seconds back
+-fps is the frame rate to hold, 0 runs as fast as it can, default GC::FRAMERATE_MAX
+-seed defaults to the time, -record saves every update's input on exit for T12_Headless -replay
+-trace writes the profiler's events as a Chrome trace on exit and prints time per stage
+Prints how long after starting the first frame was shown and when every texture was in,
+and on exit how long inputs took to reach the screen and how steady the frame rate was
+(and with T12_TRACK_ALLOCS how many frames allocated, see AllocTracker.h)
+the rest set the entity pools and balancing, see Config.h, -stress N fills a world scaled to fit the window with N rocks
+*/
+int main(int argc, char* argv[])
 {
+	Clock startup;		//time to first frame and to everything loaded are measured from here
+	FixedStep step;
+	float fps = (float)GC::FRAMERATE_MAX;
+	int numThreads = 1;
+	uint32_t seed = (uint32_t)time(0);
+	const char* recordFile = nullptr;
+	const char* traceFile = nullptr;
+	GameConfig cfg;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-tickrate") && i + 1 < argc && atof(argv[i + 1]) > 0)
+			step.SetRate((float)atof(argv[++i]));
+		else if (!strcmp(argv[i], "-fps") && i + 1 < argc && atof(argv[i + 1]) >= 0)
+			fps = (float)atof(argv[++i]);
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc && atoi(argv[i + 1]) > 0)
+			numThreads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "-record") && i + 1 < argc)
+			recordFile = argv[++i];
+		else if (!strcmp(argv[i], "-trace") && i + 1 < argc)
+			traceFile = argv[++i];
+		else if (!ParseConfigArg(argc, argv, i, cfg))
+		{
+			printf("Usage: %s [-tickrate updates_per_second] [-fps N] [-threads N] [-seed N] [-record file] [-trace file] %s\n",
+				argv[0], CONFIG_USAGE);
+			return EXIT_FAILURE;
+		}
+	}
+
 	// Create the main window
 	RenderWindow window(VideoMode(GC::SCREEN_RES.x, GC::SCREEN_RES.y), "T12_MiniShmup");
-	window.setFramerateLimit(GC::FRAMERATE_MAX);
+	window.setKeyRepeatEnabled(false);	//a held key is one press, not a stream of them
 
+	SfmlRenderer renderer(window);
 	Game game;
-	game.Init(window);
+	game.Init(window, seed, cfg);
+	game.SetThreads(numThreads);
+	game.recordInput = recordFile != nullptr;
 	//PlaceRocks(window, texRock, objects);
 
-	Clock clock;
+	RealClock clock;
+	FramePacer pacer;	//holds the frame rate, instead of the window's coarser setFramerateLimit
+	float elapsed = 0;	//length of the last frame
+	InputState input;	//frames can run with no updates, a press waits in here for one
+	bool firstFrame = true;
+	bool loaded = false;
+	FrameAllocs frameAllocs(0);	//just the totals, the game runs for as many frames as it likes
+	ProfileReset();		//leave loading out of the stage timings
+	pacer.Start(clock, fps);
 
 	// Start the game loop 
 	while (window.isOpen())
 	{
-		bool fire = false;
-		// Process events
-		Event event;
-		while (window.pollEvent(event))
+		frameAllocs.BeginFrame();
+		PROFILE_SCOPE("Frame");
 		{
-			// Close window: exit
-			if (event.type == Event::Closed)
-				window.close();
-			else if (event.type == Event::TextEntered)
+			PROFILE_SCOPE("Events");
+			// Process events
+			Event event;
+			while (window.pollEvent(event))
 			{
-				if (event.text.unicode == GC::ESCAPE_KEY)
+				// Close window: exit
+				if (event.type == Event::Closed)
 					window.close();
-			}
-			else if (event.type == Event::KeyReleased)
-			{
-				if (event.key.code == Keyboard::Space)
-					fire = true;
+				else if (event.type == Event::TextEntered)
+				{
+					if (event.text.unicode == GC::ESCAPE_KEY)
+						window.close();
+				}
+				else if (event.type == Event::KeyPressed && event.key.code == Keyboard::BackSpace)
+					game.Rewind(GC::REWIND_STEP);
+				else
+					input.HandleEvent(event, startup.getElapsedTime().asMicroseconds());
 			}
 		}
 
-		// Clear screen
-		window.clear();
-
-		float elapsed = clock.getElapsedTime().asSeconds();
-		clock.restart();
-
-		game.Update(window, elapsed, fire);
-		game.Render(window);
+		//the simulation runs in fixed steps, drawing interpolates between the last two
+		int ticks = step.Advance(elapsed);
+		for (int t = 0; t < ticks; ++t)
+			game.Update(step.dt, input.Take());
+		game.UpdateBackgrounds(elapsed);
+		if (!loaded && game.UpdateAssets())
+		{
+			loaded = true;
+			printf("Textures all in after %.1f ms (%d loaded, %.1f ms decoding)\n",
+				startup.getElapsedTime().asMicroseconds() / 1000.0, game.textures.loads, game.textures.decodeMs);
+		}
+		game.Render(renderer, step.Alpha());
 
 		// Update the window
-		window.display();
+		{
+			PROFILE_SCOPE("Display");
+			window.display();
+		}
+		input.Displayed(startup.getElapsedTime().asMicroseconds());
+		if (firstFrame)
+		{
+			firstFrame = false;
+			printf("First frame after %.1f ms\n", startup.getElapsedTime().asMicroseconds() / 1000.0);
+		}
+		elapsed = pacer.Wait();
+		frameAllocs.EndFrame();
 	}
 
+	input.PrintLatency(stdout);
+	pacer.stats.Print(stdout);
+	if (AllocTracking())
+		frameAllocs.Print(stdout);
+	if (traceFile)
+	{
+		if (!ProfileWriteChromeTrace(traceFile))
+			printf("Couldn't write trace %s\n", traceFile);
+		ProfilePrintSummary(stdout);
+	}
+	if (recordFile && !game.SaveRecording(recordFile))
+	{
+		printf("Couldn't write recording %s\n", recordFile);
+		return EXIT_FAILURE;
+	}
 	return EXIT_SUCCESS;
 }
\ No newline at end of file